@@ -0,0 +1,131 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "bench.hpp"
+#include "charset.hpp"
+#include "glContext.hpp"
+#include "renderer/drawList.hpp"
+#include "renderer/glyphAtlas.hpp"
+#include "renderer/quadBatch.hpp"
+
+
+// the two costs of text: building a `GlyphAtlas` over a whole charset, paid once per font and
+// pixel size, and a frame of a 4K wide bar worth of text, paid on every redraw. The font is given
+// on the command line as none is shipped
+static constexpr std::uint32_t WIDTH {3840u};
+static constexpr std::uint32_t HEIGHT {32u};
+static constexpr std::size_t BUILD_COUNT {10uz};
+static constexpr std::size_t FRAME_COUNT {500uz};
+static constexpr float TEXT_SIZE {16.f};
+
+// a bar shows a few labels and a clock, whose digits change every second
+static constexpr std::u32string_view WORKSPACES {U"1 web  2 code  3 chat  4 music  5 mail"};
+static constexpr std::u32string_view TITLE {U"photon-bar — renderer/glyphAtlas.cpp — Éditeur de texte"};
+static constexpr std::u32string_view STATUS {U"CPU 12%  MEM 4.2/31.1 GiB  VOL 65%  BAT 87% ⚡  wlan0 ↑ 1.2 MB/s"};
+static constexpr std::u32string_view CLOCKS[] {U"Thu 16 Oct 12:34:56", U"Thu 16 Oct 12:34:57"};
+
+// latin scripts and punctuation, what a bar in most european languages needs. Codepoints the font
+// lacks are looked up all the same
+static auto createCharset() noexcept -> photon::Charset {
+	std::vector<char32_t> characters {};
+	const auto addRange {[&characters] (char32_t first, char32_t last) noexcept {
+		for (char32_t character {first}; character <= last; ++character)
+			characters.push_back(character);
+	}};
+	addRange(0x0020, 0x007e);
+	// latin-1 supplement, latin extended A and B
+	addRange(0x00a0, 0x024f);
+	// general punctuation, currency symbols, arrows
+	addRange(0x2000, 0x206f);
+	addRange(0x20a0, 0x20bf);
+	addRange(0x2190, 0x21ff);
+	return *photon::Charset::from(characters);
+}
+
+static auto buildFrame(photon::renderer::DrawList& drawList, photon::renderer::GlyphAtlas& atlas, std::size_t frame) noexcept -> void {
+	constexpr photon::Color color {.r = 220, .g = 220, .b = 220, .a = 255};
+	constexpr std::int32_t baseline {22};
+	drawList.clear();
+	drawList.fill({.r = 20, .g = 20, .b = 30, .a = 255});
+	(void)photon::renderer::drawText(drawList, atlas, {.text = WORKSPACES, .x = 8, .baseline = baseline, .size = TEXT_SIZE, .color = color});
+	(void)photon::renderer::drawText(drawList, atlas, {.text = TITLE, .x = 1400, .baseline = baseline, .size = TEXT_SIZE, .color = color});
+	(void)photon::renderer::drawText(drawList, atlas, {.text = STATUS, .x = 3000, .baseline = baseline, .size = TEXT_SIZE, .color = color});
+	(void)photon::renderer::drawText(drawList, atlas, {
+		.text = CLOCKS[frame % std::size(CLOCKS)],
+		.x = 3650,
+		.baseline = baseline,
+		.size = TEXT_SIZE,
+		.color = color
+	});
+	atlas.flush();
+}
+
+auto main(int argc, char** argv) -> int {
+	if (argc != 2) {
+		std::println("usage: {} <font.ttf>", argv[0]);
+		return 1;
+	}
+	const std::string_view fontPath {argv[1]};
+	auto context {photon::bench::GlContext::create(WIDTH, HEIGHT)};
+	if (!context) {
+		std::println("can't create an offscreen GL 4.6 context: {}", static_cast<int> (context.error()));
+		return 1;
+	}
+	const photon::Charset charset {createCharset()};
+
+	std::chrono::duration<double, std::milli> buildTime {};
+	for (std::size_t i {0uz}; i < BUILD_COUNT; ++i) {
+		const auto start {std::chrono::steady_clock::now()};
+		auto atlas {photon::renderer::GlyphAtlas::create({.charset = charset, .fontPath = fontPath})};
+		if (!atlas) {
+			std::println("can't create the atlas: {}", static_cast<int> (atlas.error()));
+			return 1;
+		}
+		// `create` uploads the pages, wait for it to be done
+		glFinish();
+		buildTime += std::chrono::steady_clock::now() - start;
+	}
+	std::println("{:<40} {:>10.3f} ms/build   {} codepoints",
+		"atlas build",
+		buildTime.count() / static_cast<double> (BUILD_COUNT),
+		charset.getCharacters().size()
+	);
+
+	auto atlas {photon::renderer::GlyphAtlas::create({.charset = charset, .fontPath = fontPath})};
+	auto batch {photon::renderer::QuadBatch::create()};
+	if (!atlas || !batch) {
+		std::println("can't create the atlas or the quad batch");
+		return 1;
+	}
+	std::println("{} pages of the atlas in use", atlas->getPageCount());
+	batch->setViewport(WIDTH, HEIGHT);
+
+	photon::renderer::DrawList drawList {};
+	std::size_t frame {0uz};
+	// the CPU side alone, glyph lookups and draw list recording
+	(void)photon::bench::measure("drawText + flush", FRAME_COUNT, [&] noexcept {
+		for (std::size_t i {0uz}; i < FRAME_COUNT; ++i)
+			buildFrame(drawList, *atlas, frame++);
+	});
+	std::println("{} quads per frame", drawList.getCommands().size() - 1uz);
+	(void)photon::bench::measureFrames("drawText + flush + draw", FRAME_COUNT, [&] noexcept {
+		buildFrame(drawList, *atlas, frame++);
+		// a glyph inserted by the frame may have grown the texture
+		batch->setTexture(atlas->getTexture());
+		for (const auto& command : drawList.getCommands()) {
+			if (command.type == photon::renderer::DrawCommand::Type::eFill) {
+				glClearColor(0.08f, 0.08f, 0.12f, 1.f);
+				glClear(GL_COLOR_BUFFER_BIT);
+				continue;
+			}
+			batch->push(photon::renderer::toQuadInstance(command));
+		}
+		batch->endFrame();
+	});
+	return 0;
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <print>
+#include <string_view>
+#include <thread>
+
+#include "bench.hpp"
+#include "event.hpp"
+
+
+// CPU time spent by the consumer thread on bursts of events, such as a workspace switching storm,
+// when it takes them one `waitOnEvent` at a time and when it drains each burst with `waitOnEvents`
+static constexpr std::size_t BURST_COUNT {2000uz};
+static constexpr std::size_t BURST_SIZE {256uz};
+static constexpr std::chrono::microseconds BURST_PAUSE {200};
+
+enum class BenchEventType {
+	eWorkspace,
+};
+
+using BenchQueue = photon::EventQueue<BenchEventType, photon::Event<BenchEventType::eWorkspace, std::uint64_t>>;
+
+struct Visitor {
+	std::size_t handled {0uz};
+	std::uint64_t total {0u};
+
+	auto handle(photon::Event<BenchEventType::eWorkspace, std::uint64_t> event) noexcept -> void {
+		total += event.value;
+		++handled;
+	}
+};
+
+static auto getThreadCpuTime() noexcept -> std::chrono::nanoseconds {
+	timespec time {};
+	(void)clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+	return std::chrono::seconds{time.tv_sec} + std::chrono::nanoseconds{time.tv_nsec};
+}
+
+template <typename Consume>
+static auto run(std::string_view name, Consume&& consume) noexcept -> void {
+	BenchQueue queue {"batch bench"};
+	std::jthread producer {[&queue] noexcept {
+		for (std::size_t burst {0uz}; burst < BURST_COUNT; ++burst) {
+			for (std::size_t i {0uz}; i < BURST_SIZE; ++i)
+				(void)queue.push<BenchEventType::eWorkspace> (static_cast<std::uint64_t> (i));
+			std::this_thread::sleep_for(BURST_PAUSE);
+		}
+	}};
+
+	Visitor visitor {};
+	const auto start {getThreadCpuTime()};
+	while (visitor.handled < BURST_COUNT * BURST_SIZE)
+		consume(queue, visitor);
+	const std::chrono::duration<double, std::nano> cpu {getThreadCpuTime() - start};
+	producer.join();
+
+	std::println("{:<16} {:>10.1f} ms consumer CPU   {:>8.1f} ns/event",
+		name,
+		std::chrono::duration<double, std::milli> (cpu).count(),
+		cpu.count() / static_cast<double> (visitor.handled)
+	);
+	photon::bench::doNotOptimize(visitor.total);
+}
+
+auto main() -> int {
+	std::println("{} bursts of {} events", BURST_COUNT, BURST_SIZE);
+	run("waitOnEvent", [] (BenchQueue& queue, Visitor& visitor) noexcept {
+		queue.waitOnEvent(visitor);
+	});
+	run("waitOnEvents", [] (BenchQueue& queue, Visitor& visitor) noexcept {
+		(void)queue.waitOnEvents(visitor);
+	});
+	return 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <print>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace photon::bench {
+	// run `body` once to warm up, then time a second run of it and print the mean time of each of
+	// its `operations`. `setup` runs before each of them, outside of the timing
+	template <std::invocable Setup, std::invocable Body>
+	auto measure(std::string_view name, std::size_t operations, Setup&& setup, Body&& body) noexcept -> double {
+		setup();
+		body();
+		setup();
+		const auto start {std::chrono::steady_clock::now()};
+		body();
+		const std::chrono::duration<double, std::nano> elapsed {std::chrono::steady_clock::now() - start};
+		const double perOperation {elapsed.count() / static_cast<double> (operations)};
+		std::println("{:<40} {:>10.2f} ns/op", name, perOperation);
+		return perOperation;
+	}
+
+	template <std::invocable Body>
+	auto measure(std::string_view name, std::size_t operations, Body&& body) noexcept -> double {
+		return measure(name, operations, [] noexcept {}, std::forward<Body> (body));
+	}
+
+	// print the median, 99th percentile and maximum of `latencies`, which get sorted
+	inline auto printLatencies(std::string_view name, std::vector<std::chrono::nanoseconds>& latencies) noexcept -> void {
+		std::ranges::sort(latencies);
+		const auto microseconds {[&latencies] (double quantile) noexcept -> double {
+			const auto index {static_cast<std::size_t> (quantile * static_cast<double> (latencies.size() - 1uz))};
+			return std::chrono::duration<double, std::micro> (latencies[index]).count();
+		}};
+		std::println("{:<24} p50 {:>10.2f} us   p99 {:>10.2f} us   max {:>10.2f} us",
+			name, microseconds(0.5), microseconds(0.99), microseconds(1.0)
+		);
+	}
+
+	// keep the optimizer from discarding `value` and the computations it depends on
+	template <typename T>
+	auto doNotOptimize(const T& value) noexcept -> void {
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+}
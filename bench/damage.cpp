@@ -0,0 +1,127 @@
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <string_view>
+
+#include "glContext.hpp"
+#include "rect.hpp"
+#include "renderer/drawList.hpp"
+#include "renderer/quadBatch.hpp"
+
+
+// a 4K wide bar whose clock ticks, redrawn whole on every tick and redrawn through damage
+// tracking, where only the clock's rect is repainted. Frames are rendered as `Renderer::execute`
+// and `Window::beginFrame` do, scissored to the repaint bounds with the commands outside culled.
+// Glyph sized quads stand in for text, so that no font is needed
+static constexpr std::uint32_t WIDTH {3840u};
+static constexpr std::uint32_t HEIGHT {32u};
+static constexpr std::size_t FRAME_COUNT {500uz};
+static constexpr photon::Rect CLOCK {.x = 3640, .y = 0, .width = 192u, .height = HEIGHT};
+static constexpr std::uint32_t GLYPH_WIDTH {9u};
+static constexpr std::uint32_t GLYPH_HEIGHT {14u};
+
+static auto text(photon::renderer::DrawList& drawList, std::int32_t x, std::size_t length, std::size_t seed) noexcept -> void {
+	for (std::size_t i {0uz}; i < length; ++i) {
+		drawList.roundedRect({
+			.x = x + static_cast<std::int32_t> (i * (GLYPH_WIDTH + 1u)),
+			.y = 9,
+			.width = GLYPH_WIDTH,
+			.height = GLYPH_HEIGHT
+		}, 2u, {.r = 220, .g = 220, .b = static_cast<std::uint8_t> (200u + (i + seed) % 50u), .a = 255});
+	}
+}
+
+// `tick` only changes the clock
+static auto buildFrame(photon::renderer::DrawList& drawList, std::size_t tick) noexcept -> void {
+	drawList.clear();
+	drawList.fill({.r = 20, .g = 20, .b = 30, .a = 255});
+	for (std::int32_t workspace {0}; workspace < 10; ++workspace) {
+		const photon::Rect button {.x = 4 + workspace * 36, .y = 4, .width = 32u, .height = 24u};
+		drawList.roundedRect(button, 6u, {.r = 60, .g = 60, .b = 80, .a = 255});
+		drawList.border(button, 1u, {.r = 120, .g = 120, .b = 160, .a = 255}, 6u);
+		text(drawList, button.x + 11, 1uz, static_cast<std::size_t> (workspace));
+	}
+	// window title, then the status modules
+	text(drawList, 1400, 60uz, 0uz);
+	for (std::int32_t module {0}; module < 8; ++module) {
+		drawList.roundedRect({.x = 2600 + module * 130, .y = 4, .width = 120u, .height = 24u}, 6u, {.r = 40, .g = 40, .b = 55, .a = 255});
+		text(drawList, 2608 + module * 130, 10uz, static_cast<std::size_t> (module));
+	}
+	text(drawList, CLOCK.x + 6, 18uz, tick);
+}
+
+static auto execute(
+	photon::renderer::QuadBatch& batch,
+	const photon::renderer::DrawList& drawList,
+	const photon::Rect& clip
+) noexcept -> void {
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(
+		clip.x,
+		static_cast<GLint> (HEIGHT) - clip.y - static_cast<GLint> (clip.height),
+		static_cast<GLsizei> (clip.width),
+		static_cast<GLsizei> (clip.height)
+	);
+	for (const auto& command : drawList.getCommands()) {
+		if (command.type == photon::renderer::DrawCommand::Type::eFill) {
+			batch.flush();
+			glClearColor(command.color.r / 255.f, command.color.g / 255.f, command.color.b / 255.f, command.color.a / 255.f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			continue;
+		}
+		if (!command.rect.intersects(clip))
+			continue;
+		batch.push(photon::renderer::toQuadInstance(command));
+	}
+	batch.endFrame();
+	glDisable(GL_SCISSOR_TEST);
+}
+
+static auto report(std::string_view name, std::size_t quads, const photon::Rect& repaint) noexcept -> void {
+	std::println("{:<40} {:>10} quads {:>10} px repainted and reported",
+		name, quads, static_cast<std::uint64_t> (repaint.width) * repaint.height
+	);
+}
+
+auto main() -> int {
+	auto context {photon::bench::GlContext::create(WIDTH, HEIGHT)};
+	if (!context) {
+		std::println("can't create an offscreen GL 4.6 context: {}", static_cast<int> (context.error()));
+		return 1;
+	}
+	auto batch {photon::renderer::QuadBatch::create()};
+	if (!batch) {
+		std::println("can't create the quad batch: {}", static_cast<int> (batch.error()));
+		return 1;
+	}
+	batch->setViewport(WIDTH, HEIGHT);
+
+	photon::renderer::DrawList drawList {};
+	const photon::Rect surface {.x = 0, .y = 0, .width = WIDTH, .height = HEIGHT};
+	std::size_t tick {0uz};
+	const double full {photon::bench::measureFrames("full redraw", FRAME_COUNT, [&] noexcept {
+		buildFrame(drawList, tick++);
+		execute(*batch, drawList, surface);
+	})};
+	const std::size_t quadCount {drawList.getCommands().size() - 1uz};
+	report("full redraw", quadCount, surface);
+
+	// with two buffers swapped, the one drawn into holds the frame before the previous one: both
+	// clock damages are repainted, which coincide
+	photon::Region repaint {CLOCK};
+	repaint.add(CLOCK);
+	const photon::Rect bounds {repaint.getBounds()};
+	std::size_t repaintedQuadCount {0uz};
+	for (const auto& command : drawList.getCommands())
+		repaintedQuadCount += command.type != photon::renderer::DrawCommand::Type::eFill && command.rect.intersects(bounds);
+	const double damaged {photon::bench::measureFrames("damage tracked redraw", FRAME_COUNT, [&] noexcept {
+		buildFrame(drawList, tick++);
+		execute(*batch, drawList, bounds);
+	})};
+	report("damage tracked redraw", repaintedQuadCount, bounds);
+	std::println("{:.1f}x less frame time, {:.1f}x less area for the compositor",
+		full / damaged,
+		static_cast<double> (WIDTH * HEIGHT) / static_cast<double> (bounds.width * bounds.height)
+	);
+	return 0;
+}
@@ -0,0 +1,107 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+#include "event.hpp"
+
+
+// compares a dispatch through a table indexed by the event's position in `Events...` with the
+// chain of comparisons walking every alternative it replaced, over 64 event types
+static constexpr std::size_t TYPE_COUNT {64uz};
+static constexpr std::size_t EVENT_COUNT {1'000'000uz};
+
+enum class BenchEventType : std::uint32_t {};
+
+template <std::size_t I>
+struct Payload {
+	std::uint64_t value;
+};
+
+template <std::size_t I>
+using BenchEvent = photon::Event<static_cast<BenchEventType> (I), Payload<I>>;
+
+template <typename Indices>
+struct bench_queue;
+template <std::size_t... I>
+struct bench_queue<std::index_sequence<I...>> {
+	using type = photon::BasicEventQueue<photon::EventQueueConfig{.capacity = EVENT_COUNT}, BenchEventType, BenchEvent<I>...>;
+};
+using BenchQueue = bench_queue<std::make_index_sequence<TYPE_COUNT>>::type;
+
+struct Sink {
+	std::uint64_t total {0u};
+
+	template <std::size_t I>
+	auto operator()() noexcept -> void {
+		total += I + 1uz;
+	}
+};
+
+static auto chainDispatch(std::size_t index, Sink& sink) noexcept -> void {
+	[&] <std::size_t... I> (std::index_sequence<I...>) noexcept {
+		(void)((index == I ? (sink.template operator() <I> (), true) : false) || ...);
+	} (std::make_index_sequence<TYPE_COUNT> {});
+}
+
+static auto tableDispatch(std::size_t index, Sink& sink) noexcept -> void {
+	using Thunk = void(*)(Sink&) noexcept;
+	static constexpr auto table {[] <std::size_t... I> (std::index_sequence<I...>) noexcept {
+		return std::array<Thunk, TYPE_COUNT> {+[] (Sink& sink) noexcept -> void {
+			sink.template operator() <I> ();
+		}...};
+	} (std::make_index_sequence<TYPE_COUNT> {})};
+	table[index](sink);
+}
+
+struct Visitor {
+	std::uint64_t total {0u};
+
+	auto handle(auto event) noexcept -> void {
+		total += event.value.value;
+	}
+};
+
+template <std::size_t... I>
+static auto pushByIndex(BenchQueue& queue, std::size_t index, std::index_sequence<I...>) noexcept -> void {
+	(void)((index == I ? (void)queue.push<static_cast<BenchEventType> (I)> (Payload<I>{.value = I}), true : false) || ...);
+}
+
+auto main() -> int {
+	// uniformly distributed types, so that the branch predictor can't learn the sequence
+	std::mt19937 generator {42u};
+	std::uniform_int_distribution<std::size_t> distribution {0uz, TYPE_COUNT - 1uz};
+	std::vector<std::size_t> indices (EVENT_COUNT);
+	for (std::size_t& index : indices)
+		index = distribution(generator);
+
+	std::println("{} event types, {} events", TYPE_COUNT, EVENT_COUNT);
+	photon::bench::measure("chain of comparisons", EVENT_COUNT, [&indices] noexcept {
+		Sink sink {};
+		for (const std::size_t index : indices)
+			chainDispatch(index, sink);
+		photon::bench::doNotOptimize(sink.total);
+	});
+	photon::bench::measure("jump table", EVENT_COUNT, [&indices] noexcept {
+		Sink sink {};
+		for (const std::size_t index : indices)
+			tableDispatch(index, sink);
+		photon::bench::doNotOptimize(sink.total);
+	});
+
+	// the events are pushed beforehand, only the drain is timed
+	BenchQueue queue {"dispatch bench"};
+	Visitor visitor {};
+	photon::bench::measure("EventQueue drain", EVENT_COUNT, [&queue, &indices] noexcept {
+		for (const std::size_t index : indices)
+			pushByIndex(queue, index, std::make_index_sequence<TYPE_COUNT> {});
+	}, [&queue, &visitor] noexcept {
+		photon::bench::doNotOptimize(queue.drain(visitor));
+	});
+	photon::bench::doNotOptimize(visitor.total);
+	return 0;
+}
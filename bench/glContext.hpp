@@ -0,0 +1,152 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <print>
+#include <string_view>
+#include <utility>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <glad/glad.h>
+
+
+namespace photon::bench {
+	// surfaceless GL 4.6 core context rendering into a framebuffer object, so that the renderer can
+	// be measured without a compositor. Software rendering unless the environment says otherwise:
+	// numbers are comparable between machines and reflect the CPU side of the renderer, which is
+	// what is measured
+	class GlContext final {
+		public:
+			enum class CreateError {
+				eDisplayInitialization,
+				eContextCreation,
+				eFunctionLoading,
+				eFramebufferCreation,
+			};
+
+			GlContext(const GlContext&) = delete;
+			auto operator=(const GlContext&) -> GlContext& = delete;
+			auto operator=(GlContext&&) -> GlContext& = delete;
+
+			GlContext(GlContext&& other) noexcept :
+				m_display {std::exchange(other.m_display, EGL_NO_DISPLAY)},
+				m_context {std::exchange(other.m_context, EGL_NO_CONTEXT)},
+				m_framebuffer {std::exchange(other.m_framebuffer, 0u)},
+				m_renderbuffer {std::exchange(other.m_renderbuffer, 0u)},
+				m_width {other.m_width},
+				m_height {other.m_height}
+			{}
+			~GlContext() noexcept {
+				if (m_display == EGL_NO_DISPLAY)
+					return;
+				if (m_context != EGL_NO_CONTEXT) {
+					// the functions aren't loaded if creation failed before that
+					if (m_framebuffer != 0u)
+						glDeleteFramebuffers(1, &m_framebuffer);
+					if (m_renderbuffer != 0u)
+						glDeleteRenderbuffers(1, &m_renderbuffer);
+					(void)eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+					(void)eglDestroyContext(m_display, m_context);
+				}
+				(void)eglTerminate(m_display);
+			}
+
+			// the context is current on the calling thread and the framebuffer bound once created
+			[[nodiscard]]
+			static auto create(std::uint32_t width, std::uint32_t height) noexcept -> std::expected<GlContext, CreateError> {
+				// llvmpipe implements everything the renderer uses but only advertises 4.5. Doesn't
+				// override what the caller already set
+				(void)setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+				(void)setenv("MESA_GL_VERSION_OVERRIDE", "4.6", 0);
+				(void)setenv("MESA_GLSL_VERSION_OVERRIDE", "460", 0);
+
+				GlContext context {width, height};
+				const auto getPlatformDisplay {reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC> (
+					eglGetProcAddress("eglGetPlatformDisplayEXT")
+				)};
+				if (getPlatformDisplay == nullptr)
+					return std::unexpected(CreateError::eDisplayInitialization);
+				context.m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+				if (context.m_display == EGL_NO_DISPLAY)
+					return std::unexpected(CreateError::eDisplayInitialization);
+				if (eglInitialize(context.m_display, nullptr, nullptr) != EGL_TRUE)
+					return std::unexpected(CreateError::eDisplayInitialization);
+
+				if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE)
+					return std::unexpected(CreateError::eContextCreation);
+				const EGLint attributes[] {
+					EGL_CONTEXT_MAJOR_VERSION, 4,
+					EGL_CONTEXT_MINOR_VERSION, 6,
+					EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+					EGL_NONE
+				};
+				context.m_context = eglCreateContext(context.m_display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+				if (context.m_context == EGL_NO_CONTEXT)
+					return std::unexpected(CreateError::eContextCreation);
+				if (eglMakeCurrent(context.m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, context.m_context) != EGL_TRUE)
+					return std::unexpected(CreateError::eContextCreation);
+				if (gladLoadGLLoader(reinterpret_cast<GLADloadproc> (eglGetProcAddress)) == 0 || !GLAD_GL_VERSION_4_6)
+					return std::unexpected(CreateError::eFunctionLoading);
+
+				// a surfaceless context has no default framebuffer to draw into
+				glCreateRenderbuffers(1, &context.m_renderbuffer);
+				glNamedRenderbufferStorage(
+					context.m_renderbuffer,
+					GL_RGBA8,
+					static_cast<GLsizei> (width),
+					static_cast<GLsizei> (height)
+				);
+				glCreateFramebuffers(1, &context.m_framebuffer);
+				glNamedFramebufferRenderbuffer(context.m_framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, context.m_renderbuffer);
+				if (glCheckNamedFramebufferStatus(context.m_framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+					return std::unexpected(CreateError::eFramebufferCreation);
+				glBindFramebuffer(GL_FRAMEBUFFER, context.m_framebuffer);
+				glViewport(0, 0, static_cast<GLsizei> (width), static_cast<GLsizei> (height));
+				return context;
+			}
+
+			inline auto getWidth() const noexcept -> std::uint32_t {
+				return m_width;
+			}
+			inline auto getHeight() const noexcept -> std::uint32_t {
+				return m_height;
+			}
+
+		private:
+			GlContext(std::uint32_t width, std::uint32_t height) noexcept :
+				m_width {width},
+				m_height {height}
+			{}
+
+			EGLDisplay m_display {EGL_NO_DISPLAY};
+			EGLContext m_context {EGL_NO_CONTEXT};
+			GLuint m_framebuffer {0u};
+			GLuint m_renderbuffer {0u};
+			std::uint32_t m_width;
+			std::uint32_t m_height;
+	};
+
+	// run `frame` for a few warm up frames, then `frames` more and print the mean wall time of one.
+	// Each frame waits for the GPU, otherwise only the submission would be measured
+	template <std::invocable Frame>
+	auto measureFrames(std::string_view name, std::size_t frames, Frame&& frame) noexcept -> double {
+		for (std::size_t i {0uz}; i < 10uz; ++i) {
+			frame();
+			glFinish();
+		}
+		const auto start {std::chrono::steady_clock::now()};
+		for (std::size_t i {0uz}; i < frames; ++i) {
+			frame();
+			glFinish();
+		}
+		const std::chrono::duration<double, std::milli> elapsed {std::chrono::steady_clock::now() - start};
+		const double perFrame {elapsed.count() / static_cast<double> (frames)};
+		std::println("{:<40} {:>10.3f} ms/frame", name, perFrame);
+		return perFrame;
+	}
+}
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <latch>
+#include <memory>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "bench.hpp"
+#include "event.hpp"
+
+
+// the same modules, each handling one tick per round, run once with a thread and a queue per
+// module and once as coroutines sharing a single queue and a single thread
+static constexpr std::size_t MODULE_COUNT {48uz};
+static constexpr std::size_t ROUND_COUNT {10'000uz};
+
+enum class BenchEventType {
+	eTick,
+};
+
+using BenchQueue = photon::EventQueue<BenchEventType, photon::Event<BenchEventType::eTick, std::uint64_t>>;
+
+struct Usage {
+	std::uint64_t contextSwitches;
+	std::uint64_t residentKilobytes;
+};
+
+// context switches of every thread of the process, voluntary or not, and its current resident set
+static auto getUsage() noexcept -> Usage {
+	rusage usage {};
+	(void)getrusage(RUSAGE_SELF, &usage);
+	Usage result {
+		.contextSwitches = static_cast<std::uint64_t> (usage.ru_nvcsw + usage.ru_nivcsw),
+		.residentKilobytes = 0u
+	};
+	std::ifstream status {"/proc/self/status"};
+	for (std::string line {}; std::getline(status, line);) {
+		if (line.starts_with("VmRSS:"))
+			result.residentKilobytes = std::stoull(line.substr(6uz));
+	}
+	return result;
+}
+
+// the resident set is sampled once every module is started but before any tick, it is the memory
+// taken by the modules themselves
+static auto printUsage(std::string_view name, const Usage& before, const Usage& started, const Usage& after, std::chrono::duration<double, std::milli> elapsed) noexcept -> void {
+	std::println("{:<20} {:>10.1f} ms   {:>10} context switches   {:>8} kB resident",
+		name, elapsed.count(), after.contextSwitches - before.contextSwitches, started.residentKilobytes - before.residentKilobytes
+	);
+}
+
+struct Module {
+	std::uint64_t total {0u};
+
+	auto handle(photon::Event<BenchEventType::eTick, std::uint64_t> event) noexcept -> void {
+		total += event.value;
+	}
+};
+
+static auto runThreads() noexcept -> void {
+	std::vector<std::unique_ptr<BenchQueue>> queues {};
+	for (std::size_t i {0uz}; i < MODULE_COUNT; ++i)
+		queues.push_back(std::make_unique<BenchQueue> ("modules bench"));
+
+	const Usage before {getUsage()};
+	const auto start {std::chrono::steady_clock::now()};
+	std::latch ready {static_cast<std::ptrdiff_t> (MODULE_COUNT)};
+	std::vector<std::jthread> threads {};
+	for (const auto& queue : queues) {
+		threads.emplace_back([&queue = *queue, &ready] noexcept {
+			Module module {};
+			ready.count_down();
+			for (std::size_t round {0uz}; round < ROUND_COUNT; ++round)
+				queue.waitOnEvent(module);
+			photon::bench::doNotOptimize(module.total);
+		});
+	}
+	ready.wait();
+	const Usage started {getUsage()};
+	for (std::size_t round {0uz}; round < ROUND_COUNT; ++round) {
+		for (const auto& queue : queues)
+			(void)queue->push<BenchEventType::eTick> (static_cast<std::uint64_t> (round));
+	}
+	threads.clear();
+	printUsage("thread per module", before, started, getUsage(), std::chrono::steady_clock::now() - start);
+}
+
+static auto runModule(BenchQueue& queue, std::uint64_t& total) noexcept -> photon::events::Task {
+	for (std::size_t round {0uz}; round < ROUND_COUNT; ++round) {
+		const auto tick {co_await queue.next<BenchEventType::eTick> ()};
+		total += tick.value;
+	}
+}
+
+static auto runCoroutines() noexcept -> void {
+	BenchQueue queue {"modules bench"};
+	photon::events::CoroutineScheduler scheduler {};
+	std::vector<std::uint64_t> totals (MODULE_COUNT, 0u);
+
+	const Usage before {getUsage()};
+	const auto start {std::chrono::steady_clock::now()};
+	for (std::uint64_t& total : totals)
+		scheduler.spawn(runModule(queue, total));
+	scheduler.runReady();
+	const Usage started {getUsage()};
+	std::jthread producer {[&queue] noexcept {
+		for (std::size_t round {0uz}; round < ROUND_COUNT; ++round) {
+			for (std::size_t i {0uz}; i < MODULE_COUNT; ++i)
+				(void)queue.push<BenchEventType::eTick> (static_cast<std::uint64_t> (round));
+		}
+	}};
+	queue.serve(scheduler);
+	producer.join();
+	printUsage("coroutines", before, started, getUsage(), std::chrono::steady_clock::now() - start);
+	photon::bench::doNotOptimize(totals.data());
+}
+
+auto main() -> int {
+	std::println("{} modules, {} ticks each", MODULE_COUNT, ROUND_COUNT);
+	runThreads();
+	runCoroutines();
+	return 0;
+}
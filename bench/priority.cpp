@@ -0,0 +1,86 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "event.hpp"
+
+
+// time between pushing a click and handling it while a sampler floods the queue with low priority
+// updates, with the click in a higher lane than the flood and then sharing its lane as a single
+// FIFO would
+static constexpr std::size_t CLICK_COUNT {1000uz};
+static constexpr std::chrono::microseconds CLICK_PERIOD {500};
+static constexpr std::size_t LANE_CAPACITY {4096uz};
+// work done by the consumer for each update, so that the flood keeps the lane full
+static constexpr std::uint32_t UPDATE_WORK {64u};
+
+enum class BenchEventType {
+	eClick,
+	eUpdate,
+};
+
+template <photon::EventPriority clickPriority>
+using BenchQueue = photon::BasicEventQueue<photon::EventQueueConfig{
+		.capacity = LANE_CAPACITY,
+		.bounded = true
+	},
+	BenchEventType,
+	photon::Event<BenchEventType::eClick, std::chrono::steady_clock::time_point, photon::EventConfig{.priority = clickPriority}>,
+	photon::Event<BenchEventType::eUpdate, std::uint64_t, photon::EventConfig{.priority = photon::EventPriority::eLow}>
+>;
+
+template <photon::EventPriority clickPriority>
+struct Visitor {
+	std::vector<std::chrono::nanoseconds> latencies {};
+	std::uint64_t total {0u};
+
+	auto handle(photon::Event<BenchEventType::eClick, std::chrono::steady_clock::time_point, photon::EventConfig{.priority = clickPriority}> event) noexcept -> void {
+		latencies.push_back(std::chrono::steady_clock::now() - event.value);
+	}
+	auto handle(photon::Event<BenchEventType::eUpdate, std::uint64_t, photon::EventConfig{.priority = photon::EventPriority::eLow}> event) noexcept -> void {
+		for (std::uint32_t i {0u}; i < UPDATE_WORK; ++i)
+			total = total * 31u + event.value;
+		photon::bench::doNotOptimize(total);
+	}
+};
+
+template <photon::EventPriority clickPriority>
+static auto run(std::string_view name) noexcept -> void {
+	BenchQueue<clickPriority> queue {"priority bench"};
+	std::atomic<bool> running {true};
+
+	std::jthread flood {[&queue, &running] noexcept {
+		for (std::uint64_t value {0u}; running.load(std::memory_order::relaxed); ++value)
+			(void)queue.template push<BenchEventType::eUpdate> (value);
+	}};
+	std::jthread clicks {[&queue] noexcept {
+		for (std::size_t i {0uz}; i < CLICK_COUNT; ++i) {
+			std::this_thread::sleep_for(CLICK_PERIOD);
+			(void)queue.template push<BenchEventType::eClick> (std::chrono::steady_clock::now());
+		}
+	}};
+
+	Visitor<clickPriority> visitor {};
+	visitor.latencies.reserve(CLICK_COUNT);
+	while (visitor.latencies.size() < CLICK_COUNT)
+		queue.waitOnEvents(visitor);
+	running.store(false, std::memory_order::relaxed);
+	// unblocks the flood if it is waiting for room
+	queue.drain(visitor);
+	flood.join();
+	queue.drain(visitor);
+	photon::bench::printLatencies(name, visitor.latencies);
+}
+
+auto main() -> int {
+	std::println("{} clicks under a flood of low priority updates", CLICK_COUNT);
+	run<photon::EventPriority::eHigh> ("click in its own lane");
+	run<photon::EventPriority::eLow> ("click behind the flood");
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <string_view>
+
+#include "glContext.hpp"
+#include "renderer/quadBatch.hpp"
+
+
+// time of a frame of `QUAD_COUNT` quads drawn through a `QuadBatch`, from the first push to the
+// end of the rendering. Each quad has a cell of its own so that overdraw doesn't weigh in
+static constexpr std::uint32_t WIDTH {2560u};
+static constexpr std::uint32_t HEIGHT {1440u};
+static constexpr std::size_t QUAD_COUNT {10'000uz};
+static constexpr std::uint16_t QUAD_SIZE {14u};
+static constexpr std::uint16_t CELL_SIZE {16u};
+static constexpr std::size_t FRAME_COUNT {200uz};
+
+static auto run(
+	photon::renderer::QuadBatch& batch,
+	std::string_view name,
+	std::uint16_t radius,
+	std::uint16_t borderWidth
+) noexcept -> void {
+	constexpr std::size_t columns {WIDTH / CELL_SIZE};
+	photon::bench::measureFrames(name, FRAME_COUNT, [&] noexcept {
+		glClearColor(0.f, 0.f, 0.f, 1.f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		for (std::size_t i {0uz}; i < QUAD_COUNT; ++i) {
+			batch.push(photon::renderer::QuadInstance{
+				.x = static_cast<std::int16_t> ((i % columns) * CELL_SIZE),
+				.y = static_cast<std::int16_t> ((i / columns) * CELL_SIZE),
+				.width = QUAD_SIZE,
+				.height = QUAD_SIZE,
+				.color = 0xff'40'80'c0u + static_cast<std::uint32_t> (i & 0x3fuz),
+				.radius = radius,
+				.borderWidth = borderWidth,
+				.u0 = 0u,
+				.v0 = 0u,
+				.u1 = 0u,
+				.v1 = 0u,
+				.flags = photon::renderer::QuadInstance::eNone,
+				.layer = 0u
+			});
+		}
+		batch.endFrame();
+	});
+}
+
+auto main() -> int {
+	auto context {photon::bench::GlContext::create(WIDTH, HEIGHT)};
+	if (!context) {
+		std::println("can't create an offscreen GL 4.6 context: {}", static_cast<int> (context.error()));
+		return 1;
+	}
+	auto batch {photon::renderer::QuadBatch::create()};
+	if (!batch) {
+		std::println("can't create the quad batch: {}", static_cast<int> (batch.error()));
+		return 1;
+	}
+	batch->setViewport(WIDTH, HEIGHT);
+	std::println("{} quads of {}x{} per frame, {}x{} on {}",
+		QUAD_COUNT, QUAD_SIZE, QUAD_SIZE, WIDTH, HEIGHT, reinterpret_cast<const char*> (glGetString(GL_RENDERER))
+	);
+
+	// the part of every frame that isn't the quads
+	photon::bench::measureFrames("clear only", FRAME_COUNT, [] noexcept {
+		glClearColor(0.f, 0.f, 0.f, 1.f);
+		glClear(GL_COLOR_BUFFER_BIT);
+	});
+	run(*batch, "filled", 0u, 0u);
+	run(*batch, "rounded", 4u, 0u);
+	run(*batch, "rounded border", 4u, 2u);
+	return 0;
+}
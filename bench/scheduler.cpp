@@ -0,0 +1,79 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "event.hpp"
+
+
+// a worker hands results over to the consumer thread one at a time, either by pushing an event
+// handled by a visitor or by completing a sender scheduled on the queue. Measures the time from
+// the hand-over to its handling, and how many entries the consumer dispatched for each result
+static constexpr std::size_t RESULT_COUNT {100'000uz};
+
+enum class BenchEventType {
+	eResult,
+};
+
+using BenchQueue = photon::EventQueue<BenchEventType, photon::Event<BenchEventType::eResult, std::chrono::steady_clock::time_point>>;
+
+struct Consumer {
+	std::vector<std::chrono::nanoseconds> latencies {};
+	std::atomic<std::uint64_t> handled {0u};
+
+	auto complete(std::chrono::steady_clock::time_point handedOver) noexcept -> void {
+		latencies.push_back(std::chrono::steady_clock::now() - handedOver);
+		handled.fetch_add(1u, std::memory_order::release);
+		handled.notify_one();
+	}
+
+	auto handle(photon::Event<BenchEventType::eResult, std::chrono::steady_clock::time_point> event) noexcept -> void {
+		this->complete(event.value);
+	}
+};
+
+// `handOver` is called by the worker for each result, which waits for the previous one to be
+// handled so that the latency doesn't include queueing
+template <typename HandOver>
+static auto run(std::string_view name, BenchQueue& queue, Consumer& consumer, HandOver&& handOver) noexcept -> void {
+	consumer.latencies.clear();
+	consumer.latencies.reserve(RESULT_COUNT);
+	consumer.handled.store(0u, std::memory_order::relaxed);
+
+	std::jthread worker {[&consumer, &handOver] noexcept {
+		for (std::uint64_t i {0u}; i < RESULT_COUNT; ++i) {
+			handOver(std::chrono::steady_clock::now());
+			consumer.handled.wait(i, std::memory_order::acquire);
+		}
+	}};
+	std::size_t dispatched {0uz};
+	while (consumer.handled.load(std::memory_order::acquire) < RESULT_COUNT)
+		dispatched += queue.waitOnEvents(consumer);
+	worker.join();
+
+	photon::bench::printLatencies(name, consumer.latencies);
+	std::println("{:<24} {:.2f} dispatches per result", "", static_cast<double> (dispatched) / static_cast<double> (RESULT_COUNT));
+}
+
+auto main() -> int {
+	BenchQueue queue {"scheduler bench"};
+	Consumer consumer {};
+	std::println("{} results handed over to the consumer thread", RESULT_COUNT);
+
+	run("push / visit", queue, consumer, [&queue] (std::chrono::steady_clock::time_point handedOver) noexcept {
+		(void)queue.push<BenchEventType::eResult> (handedOver);
+	});
+
+	const auto scheduler {queue.getScheduler()};
+	run("schedule | then", queue, consumer, [&scheduler, &consumer] (std::chrono::steady_clock::time_point handedOver) noexcept {
+		photon::events::startDetached(photon::events::schedule(scheduler) | photon::events::then([&consumer, handedOver] noexcept {
+			consumer.complete(handedOver);
+		}));
+	});
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "event.hpp"
+
+
+// events per second through the lock-free ring and the mutex backend, for a growing number of
+// producers pushing as fast as they can into a single consumer
+static constexpr std::size_t EVENT_COUNT {2'000'000uz};
+static constexpr std::array<std::size_t, 4uz> PRODUCER_COUNTS {1uz, 2uz, 4uz, 8uz};
+static constexpr std::size_t CAPACITY {1024uz};
+
+enum class BenchEventType {
+	eSample,
+};
+
+template <photon::EventQueueBackend backend>
+using BenchQueue = photon::BasicEventQueue<photon::EventQueueConfig{
+		.backend = backend,
+		.capacity = CAPACITY,
+		.bounded = true
+	},
+	BenchEventType,
+	photon::Event<BenchEventType::eSample, std::uint64_t>
+>;
+
+struct Visitor {
+	std::size_t handled {0uz};
+
+	auto handle(photon::Event<BenchEventType::eSample, std::uint64_t>) noexcept -> void {
+		++handled;
+	}
+};
+
+template <photon::EventQueueBackend backend>
+static auto run(std::string_view name, std::size_t producerCount) noexcept -> void {
+	BenchQueue<backend> queue {"throughput bench"};
+	const std::size_t eventsPerProducer {EVENT_COUNT / producerCount};
+	const auto start {std::chrono::steady_clock::now()};
+
+	std::vector<std::jthread> producers {};
+	for (std::size_t producer {0uz}; producer < producerCount; ++producer) {
+		producers.emplace_back([&queue, eventsPerProducer] noexcept {
+			for (std::size_t i {0uz}; i < eventsPerProducer; ++i)
+				(void)queue.template push<BenchEventType::eSample> (static_cast<std::uint64_t> (i));
+		});
+	}
+	Visitor visitor {};
+	while (visitor.handled < eventsPerProducer * producerCount)
+		queue.waitOnEvents(visitor);
+	producers.clear();
+
+	const std::chrono::duration<double> elapsed {std::chrono::steady_clock::now() - start};
+	std::println("{:<16} {:>2} producers {:>12.0f} events/s",
+		name, producerCount, static_cast<double> (visitor.handled) / elapsed.count()
+	);
+	photon::bench::doNotOptimize(visitor.handled);
+}
+
+auto main() -> int {
+	std::println("{} events through lanes of {}", EVENT_COUNT, CAPACITY);
+	for (const std::size_t producerCount : PRODUCER_COUNTS) {
+		run<photon::EventQueueBackend::eMutex> ("mutex", producerCount);
+		run<photon::EventQueueBackend::eLockFreeRing> ("lock-free ring", producerCount);
+	}
+	return 0;
+}
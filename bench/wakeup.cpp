@@ -0,0 +1,107 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "bench.hpp"
+#include "event.hpp"
+
+
+// producers push 1M events, once back to back and once in bursts separated by short pauses.
+// Compares the plain futex wakeup with the spin-then-park one. A futex call is only needed when
+// the consumer runs out of events and parks, so their count follows the number of idle gaps in
+// the load rather than the number of events : a handful when the consumer never runs dry, about
+// one wait and one wake per burst otherwise
+static constexpr std::size_t EVENT_COUNT {1'000'000uz};
+static constexpr std::size_t PRODUCER_COUNT {4uz};
+static constexpr std::size_t BURST_SIZE {32uz};
+static constexpr std::chrono::microseconds BURST_PAUSE {20};
+
+struct Load {
+	std::string_view name;
+	std::size_t producers;
+	// events pushed by a producer between two pauses, 0 for none
+	std::size_t burstSize;
+};
+
+static constexpr std::array LOADS {
+	Load{.name = "back to back", .producers = PRODUCER_COUNT, .burstSize = 0uz},
+	Load{.name = "paused bursts", .producers = 1uz, .burstSize = BURST_SIZE},
+};
+
+enum class BenchEventType {
+	eSample,
+};
+
+// instrumentation is only enabled for `getStatistics`, which reports the futex calls of the
+// spin-then-park wakeup
+template <photon::EventQueueWakeup wakeup>
+using BenchQueue = photon::BasicEventQueue<photon::EventQueueConfig{
+		.wakeup = wakeup,
+		.instrumentation = true
+	},
+	BenchEventType,
+	photon::Event<BenchEventType::eSample, std::uint64_t>
+>;
+
+struct Visitor {
+	std::size_t handled {0uz};
+
+	auto handle(photon::Event<BenchEventType::eSample, std::uint64_t>) noexcept -> void {
+		++handled;
+	}
+};
+
+// voluntary context switches of the calling thread, on the consumer each of them is a park that
+// did sleep
+static auto getContextSwitches() noexcept -> std::uint64_t {
+	rusage usage {};
+	(void)getrusage(RUSAGE_THREAD, &usage);
+	return static_cast<std::uint64_t> (usage.ru_nvcsw);
+}
+
+template <photon::EventQueueWakeup wakeup>
+static auto run(std::string_view name, const Load& load) noexcept -> void {
+	BenchQueue<wakeup> queue {"wakeup bench"};
+	const std::uint64_t switchesBefore {getContextSwitches()};
+	const auto start {std::chrono::steady_clock::now()};
+
+	std::vector<std::jthread> producers {};
+	for (std::size_t producer {0uz}; producer < load.producers; ++producer) {
+		producers.emplace_back([&queue, &load] noexcept {
+			for (std::size_t i {0uz}; i < EVENT_COUNT / load.producers; ++i) {
+				(void)queue.template push<BenchEventType::eSample> (static_cast<std::uint64_t> (i));
+				if (load.burstSize != 0uz && (i + 1uz) % load.burstSize == 0uz)
+					std::this_thread::sleep_for(BURST_PAUSE);
+			}
+		});
+	}
+	Visitor visitor {};
+	while (visitor.handled < EVENT_COUNT / load.producers * load.producers)
+		queue.waitOnEvents(visitor);
+	producers.clear();
+
+	const std::chrono::duration<double, std::milli> elapsed {std::chrono::steady_clock::now() - start};
+	const std::uint64_t switches {getContextSwitches() - switchesBefore};
+	const auto futexCalls {queue.getStatistics().futexCalls};
+	std::println("{:<16} {:<16} {:>10.1f} ms   {:>10} consumer parks   {:>10} futex calls",
+		load.name, name, elapsed.count(), switches, futexCalls ? std::to_string(*futexCalls) : std::string{"untracked"}
+	);
+	photon::bench::doNotOptimize(visitor.handled);
+}
+
+auto main() -> int {
+	std::println("{} events, futex calls are only counted by the spin-then-park wakeup", EVENT_COUNT);
+	for (const Load& load : LOADS) {
+		run<photon::EventQueueWakeup::eFutex> ("futex", load);
+		run<photon::EventQueueWakeup::eSpinThenPark> ("spin then park", load);
+	}
+	return 0;
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include <flex/core/typeTraits.hpp>
+
+#include "event.hpp"
+#include "events/signal.hpp"
+#include "events/slot.hpp"
+#include "utils/utils.hpp"
+
+
+namespace photon {
+	struct BroadcastQueueConfig {
+		// number of events kept in the shared ring, rounded up to a power of two. Once it is full,
+		// producers wait for the slowest subscriber
+		std::size_t capacity {1024uz};
+		std::size_t maxSubscribers {8uz};
+		// events bigger than this are stored out-of-line instead of directly in the ring
+		std::size_t inlineEventSize {64uz};
+	};
+
+	enum class SubscribeError {
+		eTooManySubscribers,
+	};
+
+	namespace internals::events {
+		template <typename Visitor, typename Key, typename Event>
+		concept broadcast_visitor_with_specific_event = requires(Visitor visitor, const Event& event) {
+			{visitor.handle(event)} -> std::same_as<void>;
+			requires noexcept(visitor.handle(event));
+		}
+			&& event_key<Key>
+			&& event_of_key<Event, Key>;
+
+		template <typename Visitor, typename Key, typename... Events>
+		concept broadcast_visitor_of_events = (broadcast_visitor_with_specific_event<
+				Visitor,
+				Key,
+				Events
+			> && ...)
+			&& event_key<Key>
+			&& (event_of_key<Events, Key> && ...);
+	}
+
+
+	// every event pushed is stored once in a shared ring and handed by const reference to each
+	// subscriber, which reads it through its own cursor. A cell is only overwritten once every
+	// subscriber moved past it, so adding observers doesn't add any work on the producer side.
+	// Priorities, coalescing and overflow policies of the events are not supported
+	template <BroadcastQueueConfig config, event_key Key, internals::events::event_of_key<Key>... Events>
+	requires (!internals::events::has_key_duplicate<Key, Events...>::value)
+	class BasicBroadcastQueue final {
+		template <Key key>
+		using value_from_key = typename internals::events::get_value_from_key<Key, key, Events...>::type;
+		template <Key key>
+		static constexpr std::size_t index_from_key {internals::events::get_index_from_key<Key, key, Events...>::value};
+		using Slot = internals::events::EventSlot<config.inlineEventSize, Events...>;
+		static_assert(config.capacity > 0uz && config.maxSubscribers > 0uz, "Broadcast queue can't be empty");
+		static_assert((!Events::config.coalesce && ...), "Coalescing events can't be broadcast");
+		static constexpr std::size_t CAPACITY {std::bit_ceil(config.capacity)};
+		static constexpr std::size_t MASK {CAPACITY - 1uz};
+		static constexpr std::size_t INACTIVE {std::numeric_limits<std::size_t>::max()};
+
+		struct Cell {
+			// `position + 1` once the event of `position` is published
+			std::atomic<std::size_t> sequence;
+			Slot slot;
+		};
+		struct alignas(photon::utils::CACHE_LINE_SIZE) Cursor {
+			// next position to read, `INACTIVE` while nobody owns the cursor
+			std::atomic<std::size_t> position {INACTIVE};
+		};
+
+		public:
+			class Subscription final {
+				friend BasicBroadcastQueue;
+				public:
+					~Subscription() noexcept {
+						if (m_queue != nullptr)
+							m_queue->unsubscribe(*m_cursor);
+					}
+					Subscription(const Subscription&) = delete;
+					auto operator=(const Subscription&) -> Subscription& = delete;
+					Subscription(Subscription&& other) noexcept :
+						m_queue {std::exchange(other.m_queue, nullptr)},
+						m_cursor {std::exchange(other.m_cursor, nullptr)}
+					{}
+					auto operator=(Subscription&&) -> Subscription& = delete;
+
+					// dispatch up to `maxEvents` of the events published since the last call, in
+					// order, without blocking
+					auto poll(
+						internals::events::broadcast_visitor_of_events<Key, Events...> auto& visitor,
+						std::size_t maxEvents = std::numeric_limits<std::size_t>::max()
+					) noexcept -> std::size_t {
+						return m_queue->poll(*m_cursor, visitor, maxEvents);
+					}
+
+					auto waitOnEvents(
+						internals::events::broadcast_visitor_of_events<Key, Events...> auto& visitor,
+						std::size_t maxEvents = std::numeric_limits<std::size_t>::max()
+					) noexcept -> std::size_t {
+						std::size_t count {0uz};
+						m_queue->m_published.wait([this, &visitor, &count, maxEvents] noexcept {
+							count = m_queue->poll(*m_cursor, visitor, maxEvents);
+							return count != 0uz;
+						});
+						return count;
+					}
+
+				private:
+					Subscription(BasicBroadcastQueue& queue, Cursor& cursor) noexcept :
+						m_queue {&queue},
+						m_cursor {&cursor}
+					{}
+
+					BasicBroadcastQueue* m_queue;
+					Cursor* m_cursor;
+			};
+
+			BasicBroadcastQueue(std::string_view name) noexcept :
+				m_name {name},
+				m_id {},
+				m_claim {0uz},
+				m_cells {std::make_unique<Cell[]> (CAPACITY)},
+				m_cursors {},
+				m_published {},
+				m_space {}
+			{
+				static std::atomic<std::size_t> id {0uz};
+				m_id = id.fetch_add(1uz, std::memory_order::relaxed);
+				// as if the lap before the first one had been published
+				for (std::size_t i {0uz}; i < CAPACITY; ++i)
+					m_cells[i].sequence.store(i + 1uz - CAPACITY, std::memory_order::relaxed);
+			}
+			~BasicBroadcastQueue() noexcept = default;
+			BasicBroadcastQueue(const BasicBroadcastQueue&) = delete;
+			auto operator=(const BasicBroadcastQueue&) -> BasicBroadcastQueue& = delete;
+			BasicBroadcastQueue(BasicBroadcastQueue&&) = delete;
+			auto operator=(BasicBroadcastQueue&&) -> BasicBroadcastQueue& = delete;
+
+			constexpr auto getId() const noexcept -> std::size_t {
+				return m_id;
+			}
+
+			// the subscription only sees events pushed after this call. It must not outlive the queue
+			auto subscribe() noexcept -> std::expected<Subscription, SubscribeError> {
+				for (auto& cursor : m_cursors) {
+					std::size_t position {INACTIVE};
+					if (!cursor.position.compare_exchange_strong(position, m_claim.load()))
+						continue;
+					// producers that claimed before the cursor became visible may overwrite older
+					// positions, so only start from the ones claimed after
+					cursor.position.store(m_claim.load());
+					return Subscription{*this, cursor};
+				}
+				return std::unexpected(SubscribeError::eTooManySubscribers);
+			}
+
+			// the event is written to the ring even if nobody is subscribed, its slot is then simply
+			// never read before being overwritten
+			template <Key key>
+			auto push(flex::forward_of<value_from_key<key>> auto&& value) noexcept -> void {
+				static constexpr std::size_t index {index_from_key<key>};
+				const std::size_t position {m_claim.fetch_add(1uz)};
+				Cell& cell {m_cells[position & MASK]};
+				// the previous lap of the cell is published by another producer, then read by every
+				// subscriber
+				m_published.wait([&cell, position] noexcept {
+					return cell.sequence.load(std::memory_order::acquire) == position + 1uz - CAPACITY;
+				});
+				m_space.wait([this, position] noexcept {
+					return this->getSlowestPosition() + CAPACITY > position;
+				});
+				cell.slot.template emplace<index> (
+					static_cast<std::uint32_t> (index),
+					m_id,
+					position,
+					std::forward<decltype(value)> (value)
+				);
+				cell.sequence.store(position + 1uz, std::memory_order::release);
+				// also wakes a producer of the next lap waiting on this cell
+				m_published.notifyAll();
+			}
+
+		private:
+			auto getSlowestPosition() const noexcept -> std::size_t {
+				std::size_t slowest {INACTIVE};
+				for (const auto& cursor : m_cursors)
+					slowest = std::min(slowest, cursor.position.load());
+				// `INACTIVE + CAPACITY` wraps around, clamp so that no subscriber means no gating
+				return slowest == INACTIVE ? INACTIVE - CAPACITY : slowest;
+			}
+
+			auto poll(Cursor& cursor, auto& visitor, std::size_t maxEvents) noexcept -> std::size_t {
+				std::size_t position {cursor.position.load(std::memory_order::relaxed)};
+				std::size_t count {0uz};
+				for (; count < maxEvents; ++count) {
+					const Cell& cell {m_cells[position & MASK]};
+					if (cell.sequence.load(std::memory_order::acquire) != position + 1uz)
+						break;
+					cell.slot.visit([&visitor] (const auto& event) noexcept {
+						visitor.handle(event);
+					});
+					cursor.position.store(++position, std::memory_order::release);
+				}
+				if (count != 0uz)
+					m_space.notifyAll();
+				return count;
+			}
+
+			auto unsubscribe(Cursor& cursor) noexcept -> void {
+				cursor.position.store(INACTIVE);
+				m_space.notifyAll();
+			}
+
+			std::string m_name;
+			std::size_t m_id;
+			alignas(photon::utils::CACHE_LINE_SIZE) std::atomic<std::size_t> m_claim;
+			std::unique_ptr<Cell[]> m_cells;
+			std::array<Cursor, config.maxSubscribers> m_cursors;
+			photon::events::Signal m_published;
+			// woken when subscribers move forward, for the gated producers
+			photon::events::Signal m_space;
+	};
+
+	template <event_key Key, internals::events::event_of_key<Key>... Events>
+	using BroadcastEventQueue = BasicBroadcastQueue<BroadcastQueueConfig{}, Key, Events...>;
+}
@@ -1,16 +1,43 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <concepts>
-#include <condition_variable>
+#include <coroutine>
 #include <cstddef>
-#include <memory>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <expected>
+#include <functional>
+#include <limits>
 #include <mutex>
-#include <queue>
+#include <optional>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
 #include <flex/core/typeTraits.hpp>
+#include <flex/enums/enums.hpp>
 
+#include "events/coroutine.hpp"
+#include "events/eventFdSignal.hpp"
+#include "events/execution.hpp"
+#include "events/mpscRing.hpp"
+#include "events/mutexQueue.hpp"
+#include "events/record.hpp"
+#include "events/selector.hpp"
+#include "events/signal.hpp"
+#include "events/slot.hpp"
+#include "events/spinSignal.hpp"
+#include "events/statistics.hpp"
+#include "events/timerWheel.hpp"
 #include "utils/utils.hpp"
 
 
@@ -23,18 +50,101 @@ namespace photon {
 	template <typename Key>
 	concept event_key = std::is_scoped_enum_v<Key>;
 
+	enum class EventPriority {
+		eLow,
+		eNormal,
+		eHigh,
+	};
+
+	// what `push` does when the lane of the event is full
+	enum class OverflowPolicy {
+		// only valid in `EventConfig`, use `EventQueueConfig::overflow`
+		eQueueDefault,
+		// the producer sleeps until the consumer frees some room
+		eBlock,
+		// the pushed event is discarded
+		eDropNewest,
+		// the oldest pending event of the lane is discarded to make room, mutex backend only
+		eDropOldest,
+		// `push` returns `PushError::eQueueFull`
+		eFail,
+	};
+
+	enum class PushError {
+		eQueueFull,
+	};
+
+	struct EventConfig {
+		// events of higher priority are served first, see `EventQueueConfig::starvationLimit`
+		EventPriority priority {EventPriority::eNormal};
+		// only the latest value matters : pushing while an event of the same key is still pending
+		// overwrites its payload in place instead of enqueuing a new one
+		bool coalesce {false};
+		OverflowPolicy overflow {OverflowPolicy::eQueueDefault};
+	};
+
+	enum class EventQueueBackend {
+		// single mutex around a growable queue
+		eMutex,
+		// bounded lock-free ring
+		eLockFreeRing,
+	};
+
+	enum class EventQueueWakeup {
+		// the consumer parks on a futex
+		eFutex,
+		// the consumer waits on an eventfd, exposed through `getFd` to be multiplexed with other fds
+		eEventFd,
+		// the consumer polls for `EventQueueConfig::spinCount` rounds before parking on a futex,
+		// producers only make a syscall when it did park
+		eSpinThenPark,
+	};
+
+	struct EventQueueConfig {
+		EventQueueBackend backend {EventQueueBackend::eMutex};
+		EventQueueWakeup wakeup {EventQueueWakeup::eFutex};
+		std::uint32_t spinCount {128u};
+		// capacity of each priority lane. It is fixed for the lock-free ring, and only the initial
+		// one of the mutex backend unless `bounded` is set
+		std::size_t capacity {1024uz};
+		bool bounded {false};
+		// policy applied when a bounded lane is full, can be overridden per key
+		OverflowPolicy overflow {OverflowPolicy::eBlock};
+		// events bigger than this are stored out-of-line instead of directly in the queue
+		std::size_t inlineEventSize {64uz};
+		// number of events served from higher priorities before a waiting lower priority gets one
+		// in. It is also the size of the batches in which a priority is drained
+		std::size_t starvationLimit {32uz};
+		// timestamp every event and keep per-key latency histograms and depth counters, see
+		// `getStatistics`. Dumped to stderr when the queue is destroyed
+		bool instrumentation {false};
+		// allow pushed events to be written to an `EventRecorder`, see `startRecording`. Every value
+		// must then be `photon::events::serializable`
+		bool recording {false};
+	};
+
 	template <event_key Key>
 	struct EventBase {
-		Key key;
+		// position of the event in the `Events...` of its queue, the key itself is a static member
+		// of `Event` as it is known at compile time
+		std::uint32_t index;
 		std::size_t queueId;
 		std::size_t uuid;
 	};
 
-	template <event_key auto key, event_value Value>
-	struct Event : EventBase<decltype(key)> {
-		constexpr Event(std::size_t queueId, std::size_t uuid, flex::forward_of<Value> auto&& value) noexcept :
-			photon::EventBase<decltype(key)> {
-				.key = key,
+	template <event_key auto eventKey, event_value Value, EventConfig eventConfig = EventConfig{}>
+	struct Event : EventBase<decltype(eventKey)> {
+		static constexpr auto key {eventKey};
+		static constexpr EventConfig config {eventConfig};
+
+		constexpr Event(
+			std::uint32_t index,
+			std::size_t queueId,
+			std::size_t uuid,
+			flex::forward_of<Value> auto&& value
+		) noexcept :
+			photon::EventBase<decltype(eventKey)> {
+				.index = index,
 				.queueId = queueId,
 				.uuid = uuid
 			},
@@ -47,26 +157,33 @@ namespace photon {
 		template <event_key key, typename T>
 		struct is_event_of_key : std::false_type {};
 
-		template <event_key Key, Key key, event_value Value>
-		struct is_event_of_key<Key, Event<key, Value>> : std::true_type {};
+		template <event_key Key, Key key, event_value Value, EventConfig eventConfig>
+		struct is_event_of_key<Key, Event<key, Value, eventConfig>> : std::true_type {};
 
 		template <typename T, typename Key>
 		concept event_of_key = event_key<Key> && is_event_of_key<Key, std::remove_cvref_t<T>>::value;
 
 		template <event_key Key, event_of_key<Key> T>
 		struct get_event_key;
-		template <event_key Key, Key key, event_value Value>
-		struct get_event_key<Key, Event<key, Value>> {
+		template <event_key Key, Key key, event_value Value, EventConfig eventConfig>
+		struct get_event_key<Key, Event<key, Value, eventConfig>> {
 			static constexpr auto value = key;
 		};
 
 		template <event_key Key, event_of_key<Key> T>
 		struct get_event_value;
-		template <event_key Key, Key key, event_value Value>
-		struct get_event_value<Key, Event<key, Value>> {
+		template <event_key Key, Key key, event_value Value, EventConfig eventConfig>
+		struct get_event_value<Key, Event<key, Value, eventConfig>> {
 			using type = Value;
 		};
 
+		template <event_key Key, event_of_key<Key> T>
+		struct get_event_config;
+		template <event_key Key, Key key, event_value Value, EventConfig eventConfig>
+		struct get_event_config<Key, Event<key, Value, eventConfig>> {
+			static constexpr auto value = eventConfig;
+		};
+
 
 		template <event_key Key, Key key, event_of_key<Key>... Events>
 		struct has_key : std::false_type {};
@@ -96,6 +213,37 @@ namespace photon {
 			>;
 		};
 
+		template <event_key Key, Key key, event_of_key<Key>... Events>
+		struct get_index_from_key : std::integral_constant<std::size_t, 0uz> {};
+		template <event_key Key, Key key, event_of_key<Key> FirstEvent, event_of_key<Key>... Events>
+		struct get_index_from_key<Key, key, FirstEvent, Events...> : std::integral_constant<std::size_t,
+			get_event_key<Key, FirstEvent>::value == key
+				? 0uz
+				: 1uz + get_index_from_key<Key, key, Events...>::value
+		> {};
+
+		// one lane per priority actually used by `Events...`, ordered from the highest priority
+		template <event_key Key, event_of_key<Key>... Events>
+		struct priority_lanes {
+			static constexpr auto isUsed(EventPriority priority) noexcept -> bool {
+				return ((get_event_config<Key, Events>::value.priority == priority) || ...);
+			}
+			static constexpr auto laneOf(EventPriority priority) noexcept -> std::size_t {
+				std::size_t lane {0uz};
+				for (const auto higher : {EventPriority::eHigh, EventPriority::eNormal, EventPriority::eLow}) {
+					if (std::to_underlying(higher) <= std::to_underlying(priority))
+						break;
+					lane += isUsed(higher) ? 1uz : 0uz;
+				}
+				return lane;
+			}
+			static constexpr std::size_t count {
+				(isUsed(EventPriority::eHigh) ? 1uz : 0uz)
+				+ (isUsed(EventPriority::eNormal) ? 1uz : 0uz)
+				+ (isUsed(EventPriority::eLow) ? 1uz : 0uz)
+			};
+		};
+
 		template <typename Visitor, typename Key, typename Event>
 		concept visitor_with_specific_event = requires(Visitor visitor, Event event) {
 			{visitor.handle(std::move(event))} -> std::same_as<void>;
@@ -112,72 +260,714 @@ namespace photon {
 			> && ...)
 			&& event_key<Key>
 			&& (event_of_key<Events, Key> && ...);
+
+
+		template <EventQueueWakeup wakeup, std::uint32_t spinCount>
+		struct signal_of;
+		template <std::uint32_t spinCount>
+		struct signal_of<EventQueueWakeup::eFutex, spinCount> {
+			using type = photon::events::Signal;
+		};
+		template <std::uint32_t spinCount>
+		struct signal_of<EventQueueWakeup::eEventFd, spinCount> {
+			using type = photon::events::EventFdSignal;
+		};
+		template <std::uint32_t spinCount>
+		struct signal_of<EventQueueWakeup::eSpinThenPark, spinCount> {
+			using type = photon::events::SpinThenParkSignal<spinCount>;
+		};
+
+		template <EventQueueBackend backend, typename T>
+		struct backend_of;
+		template <typename T>
+		struct backend_of<EventQueueBackend::eMutex, T> {
+			using type = photon::events::MutexQueue<T>;
+		};
+		template <typename T>
+		struct backend_of<EventQueueBackend::eLockFreeRing, T> {
+			using type = photon::events::MpscRing<T>;
+		};
+
+
+		// stands in the queue for a coalescing event, whose payload lives in its `Mailbox`
+		template <std::size_t index>
+		struct CoalescedEvent {};
+
+		template <typename Event>
+		struct Mailbox {
+			std::mutex mutex;
+			// a `CoalescedEvent` is queued, or about to be by the producer that filled it, if and only
+			// if this holds a value
+			std::optional<Event> event;
+		};
+		struct NoMailbox {};
+
+		template <typename Event>
+		using mailbox_of = std::conditional_t<Event::config.coalesce, Mailbox<Event>, NoMailbox>;
+
+		// coroutine suspended on a queue, linked in the FIFO of the key it waits for
+		struct AwaiterNode {
+			AwaiterNode* next;
+			std::coroutine_handle<> handle;
+		};
+
+		struct AwaiterList {
+			AwaiterNode* head {nullptr};
+			AwaiterNode* tail {nullptr};
+
+			auto push(AwaiterNode& node) noexcept -> void {
+				node.next = nullptr;
+				if (tail == nullptr)
+					head = &node;
+				else
+					tail->next = &node;
+				tail = &node;
+			}
+			auto pop() noexcept -> AwaiterNode* {
+				AwaiterNode* node {head};
+				if (node == nullptr)
+					return nullptr;
+				head = node->next;
+				if (head == nullptr)
+					tail = nullptr;
+				return node;
+			}
+		};
+
+		template <typename Slot, bool timestamped>
+		struct QueueEntry {
+			Slot slot;
+		};
+		template <typename Slot>
+		struct QueueEntry<Slot, true> {
+			Slot slot;
+			std::chrono::steady_clock::time_point pushedAt;
+		};
+
+		template <std::size_t inlineSize, typename Indices, typename... Events>
+		struct slot_of;
+		template <std::size_t inlineSize, std::size_t... I, typename... Events>
+		struct slot_of<inlineSize, std::index_sequence<I...>, Events...> {
+			using type = EventSlot<inlineSize, std::conditional_t<Events::config.coalesce, CoalescedEvent<I>, Events>...>;
+		};
 	}
 
 
-	template <event_key Key, internals::events::event_of_key<Key>... Events>
+	template <EventQueueConfig config, event_key Key, internals::events::event_of_key<Key>... Events>
 	requires (!internals::events::has_key_duplicate<Key, Events...>::value)
-	class EventQueue final {
+	class BasicEventQueue final {
+		template <typename>
+		friend class photon::events::QueueScheduler;
 		template <Key key>
 		using value_from_key = typename internals::events::get_value_from_key<Key, key, Events...>::type;
+		using Slot = typename internals::events::slot_of<
+			config.inlineEventSize,
+			std::index_sequence_for<Events...>,
+			Events...
+		>::type;
+		using Entry = internals::events::QueueEntry<Slot, config.instrumentation>;
+		using Backend = typename internals::events::backend_of<config.backend, Entry>::type;
+		using Counters = std::conditional_t<config.instrumentation,
+			internals::events::QueueCounters<sizeof...(Events)>,
+			internals::events::NoCounters
+		>;
+		using Signal = typename internals::events::signal_of<config.wakeup, config.spinCount>::type;
+		using Lanes = internals::events::priority_lanes<Key, Events...>;
+		static_assert(config.starvationLimit > 0uz, "Priority lanes must be allowed to serve at least one event");
+		static_assert(config.overflow != OverflowPolicy::eQueueDefault, "The queue overflow policy can't defer to itself");
+		static_assert(!config.recording
+			|| (photon::events::serializable<typename internals::events::get_event_value<Key, Events>::type> && ...),
+			"Recording queues need a `photon::events::Serializer` for each of their values"
+		);
+		static constexpr bool IS_BOUNDED {config.bounded || config.backend == EventQueueBackend::eLockFreeRing};
+		template <Key key>
+		static constexpr std::size_t index_from_key {internals::events::get_index_from_key<Key, key, Events...>::value};
+		template <typename EventType>
+		static constexpr OverflowPolicy overflow_of {EventType::config.overflow == OverflowPolicy::eQueueDefault
+			? config.overflow
+			: EventType::config.overflow
+		};
 		public:
-			EventQueue(std::string_view name) noexcept :
+			// `co_await queue.next<key>()` suspends the coroutine until an event of `key` is served
+			template <Key key>
+			class NextAwaiter final : public internals::events::AwaiterNode {
+				friend BasicEventQueue;
+				using EventType = std::tuple_element_t<index_from_key<key>, std::tuple<Events...>>;
+				public:
+					auto await_ready() noexcept -> bool {
+						const auto backlogged {std::ranges::find_if(m_queue->m_backlog, [] (const auto& event) noexcept {
+							return event.index() == index_from_key<key>;
+						})};
+						if (backlogged == m_queue->m_backlog.end())
+							return false;
+						m_event.emplace(std::move(std::get<index_from_key<key>> (*backlogged)));
+						m_queue->m_backlog.erase(backlogged);
+						return true;
+					}
+					auto await_suspend(std::coroutine_handle<> handle) noexcept -> void {
+						this->handle = handle;
+						m_queue->m_awaiters[index_from_key<key>].push(*this);
+					}
+					auto await_resume() noexcept -> EventType {
+						return std::move(*m_event);
+					}
+
+				private:
+					NextAwaiter(BasicEventQueue& queue) noexcept :
+						internals::events::AwaiterNode {},
+						m_queue {&queue},
+						m_event {}
+					{}
+
+					BasicEventQueue* m_queue;
+					std::optional<EventType> m_event;
+			};
+
+			// `co_await queue.any()` suspends the coroutine until any event not awaited by a `next` is served
+			class AnyAwaiter final : public internals::events::AwaiterNode {
+				friend BasicEventQueue;
+				public:
+					auto await_ready() noexcept -> bool {
+						if (m_queue->m_backlog.empty())
+							return false;
+						m_event.emplace(std::move(m_queue->m_backlog.front()));
+						m_queue->m_backlog.pop_front();
+						return true;
+					}
+					auto await_suspend(std::coroutine_handle<> handle) noexcept -> void {
+						this->handle = handle;
+						m_queue->m_anyAwaiters.push(*this);
+					}
+					auto await_resume() noexcept -> std::variant<Events...> {
+						return std::move(*m_event);
+					}
+
+				private:
+					AnyAwaiter(BasicEventQueue& queue) noexcept :
+						internals::events::AwaiterNode {},
+						m_queue {&queue},
+						m_event {}
+					{}
+
+					BasicEventQueue* m_queue;
+					std::optional<std::variant<Events...>> m_event;
+			};
+
+			BasicEventQueue(std::string_view name) noexcept :
+				BasicEventQueue {name, nullptr}
+			{}
+			// also wake `selector` up on every push, see `photon::events::select`
+			BasicEventQueue(std::string_view name, photon::events::Selector& selector) noexcept :
+				BasicEventQueue {name, &selector}
+			{}
+			~BasicEventQueue() noexcept {
+				if constexpr (config.instrumentation)
+					photon::events::dumpStatistics(this->getStatistics(), stderr);
+			}
+			BasicEventQueue(const BasicEventQueue&) = delete;
+			auto operator=(const BasicEventQueue&) -> BasicEventQueue& = delete;
+			constexpr BasicEventQueue(BasicEventQueue&&) noexcept = default;
+			auto operator=(BasicEventQueue&&) -> BasicEventQueue& = delete;
+
+			constexpr auto getId() const noexcept -> std::size_t {
+				return m_id;
+			}
+
+			constexpr auto getSelector() const noexcept -> photon::events::Selector* {
+				return m_selector;
+			}
+
+			// senders scheduled on it complete on the thread consuming the queue, in between its events
+			auto getScheduler() noexcept -> photon::events::QueueScheduler<BasicEventQueue> {
+				return photon::events::QueueScheduler<BasicEventQueue> {*this};
+			}
+
+			// readable whenever events are pending, meant to be watched with poll/epoll
+			auto getFd() const noexcept -> int
+			requires (config.wakeup == EventQueueWakeup::eEventFd) {
+				return m_signal.getFd();
+			}
+
+			// only fails for keys whose overflow policy is `eFail`, dropped events are reported
+			// through `getDropCount` instead
+			template <Key key>
+			auto push(flex::forward_of<value_from_key<key>> auto&& value) noexcept -> std::expected<void, PushError> {
+				static constexpr std::size_t index {index_from_key<key>};
+				using EventType = std::tuple_element_t<index, std::tuple<Events...>>;
+				static constexpr std::size_t lane {Lanes::laneOf(EventType::config.priority)};
+				static constexpr OverflowPolicy overflow {overflow_of<EventType>};
+				static_assert(overflow != OverflowPolicy::eDropOldest || config.backend == EventQueueBackend::eMutex,
+					"Producers can't evict events from the lock-free ring"
+				);
+				const std::size_t uuid {m_uuid.fetch_add(1uz, std::memory_order::relaxed)};
+				if constexpr (config.instrumentation)
+					m_counters.onPush(index);
+				// serialized before `value` is moved into the queue, but only recorded once the event is
+				// accepted so that a replay feeds the load the consumer actually saw
+				const std::vector<std::byte>* payload {nullptr};
+				if constexpr (config.recording)
+					payload = this->template serialize<key> (value);
+				std::optional<Entry> evicted {};
+				bool accepted {};
+				if constexpr (EventType::config.coalesce) {
+					auto& mailbox {std::get<index> (m_mailboxes)};
+					{
+						std::scoped_lock<std::mutex> _ {mailbox.mutex};
+						if (mailbox.event) {
+							mailbox.event->uuid = uuid;
+							mailbox.event->value = std::forward<decltype(value)> (value);
+							// under the lock, so that the log keeps the order in which the value was overwritten
+							this->template record<key> (uuid, payload);
+							return {};
+						}
+						mailbox.event.emplace(static_cast<std::uint32_t> (index), m_id, uuid, std::forward<decltype(value)> (value));
+					}
+					// enqueued outside of the mailbox lock, so that the other producers of this key keep
+					// overwriting the pending value instead of waiting behind a full lane
+					accepted = this->template enqueue<overflow> (lane, Slot::template make<index> (), evicted);
+					if (!accepted) {
+						std::scoped_lock<std::mutex> _ {mailbox.mutex};
+						// the value of a producer that overwrote ours meanwhile is lost with it
+						if (mailbox.event->uuid != uuid)
+							m_drops[index].fetch_add(1u, std::memory_order::relaxed);
+						mailbox.event.reset();
+					}
+				}
+				else {
+					accepted = this->template enqueue<overflow> (lane, Slot::template make<index> (
+						static_cast<std::uint32_t> (index),
+						m_id,
+						uuid,
+						std::forward<decltype(value)> (value)
+					), evicted);
+				}
+				if (evicted)
+					this->evict(*evicted);
+				if (accepted) {
+					this->template record<key> (uuid, payload);
+					return {};
+				}
+				if constexpr (overflow == OverflowPolicy::eFail)
+					return std::unexpected(PushError::eQueueFull);
+				m_drops[index].fetch_add(1u, std::memory_order::relaxed);
+				return {};
+			}
+
+			// push `value` once `delay` elapsed, from the timer thread of the queue
+			template <Key key>
+			auto pushAfter(
+				std::chrono::steady_clock::duration delay,
+				flex::forward_of<value_from_key<key>> auto&& value
+			) noexcept -> photon::events::TimerId {
+				return m_timers.schedule(delay, [this, value = value_from_key<key> {std::forward<decltype(value)> (value)}] () mutable noexcept {
+					this->template push<key> (std::move(value));
+				});
+			}
+
+			// push the value returned by `producer` every `period`. Periodic events sharing a period
+			// are aligned so that they all fire on the same wakeup of the timer thread
+			template <Key key, std::invocable Producer>
+			requires flex::forward_of<std::invoke_result_t<Producer&>, value_from_key<key>>
+			auto pushEvery(std::chrono::steady_clock::duration period, Producer&& producer) noexcept -> photon::events::TimerId {
+				return m_timers.scheduleEvery(period, [this, producer = std::forward<Producer> (producer)] () mutable noexcept {
+					this->template push<key> (std::invoke(producer));
+				});
+			}
+			template <Key key>
+			requires std::copy_constructible<value_from_key<key>>
+			auto pushEvery(std::chrono::steady_clock::duration period, const value_from_key<key>& value) noexcept -> photon::events::TimerId {
+				return m_timers.scheduleEvery(period, [this, value] () noexcept {
+					this->template push<key> (value_from_key<key> {value});
+				});
+			}
+
+			auto cancelTimer(photon::events::TimerId id) noexcept -> void {
+				m_timers.cancel(id);
+			}
+
+			// every event accepted from now on is also written to `recorder`, which must outlive the
+			// recording. The timestamps of the log start from this call. Replay it with `photon::replay`
+			auto startRecording(photon::events::EventRecorder& recorder) noexcept -> void
+			requires (config.recording) {
+				recorder.restartClock();
+				m_recorder.store(&recorder, std::memory_order::release);
+			}
+			// waits for the producers still writing to the recorder, which can be destroyed once this
+			// returns
+			auto stopRecording() noexcept -> void
+			requires (config.recording) {
+				m_recorder.store(nullptr, std::memory_order::seq_cst);
+				// a record is a short buffered write, not worth parking for
+				while (m_recordWriters.load(std::memory_order::acquire) != 0uz)
+					std::this_thread::yield();
+			}
+
+			// number of events of `key` discarded by the `eDropNewest` and `eDropOldest` policies
+			template <Key key>
+			auto getDropCount() const noexcept -> std::uint64_t {
+				return m_drops[index_from_key<key>].load(std::memory_order::relaxed);
+			}
+			auto getDropCount() const noexcept -> std::uint64_t {
+				std::uint64_t count {0u};
+				for (const auto& drops : m_drops)
+					count += drops.load(std::memory_order::relaxed);
+				return count;
+			}
+
+			// approximate snapshot, safe to take from any thread while the queue is in use
+			auto getStatistics() const noexcept -> photon::events::EventQueueStatistics
+			requires (config.instrumentation) {
+				const auto uptime {std::chrono::duration<double> (std::chrono::steady_clock::now() - m_counters.creation)};
+				photon::events::EventQueueStatistics statistics {
+					.name = m_name,
+					.id = m_id,
+					.depth = m_counters.depth.load(std::memory_order::relaxed),
+					.maxDepth = m_counters.maxDepth.load(std::memory_order::relaxed),
+					.handled = 0u,
+					.uptime = uptime,
+					.eventsPerSecond = 0.0,
+					.futexCalls = std::nullopt,
+					.keys = {}
+				};
+				if constexpr (config.wakeup == EventQueueWakeup::eSpinThenPark)
+					statistics.futexCalls = m_signal.getSyscallCount();
+				statistics.keys.reserve(sizeof...(Events));
+				[&] <std::size_t... I> (std::index_sequence<I...>) noexcept {
+					(statistics.keys.push_back(photon::events::KeyStatistics{
+						.name = std::string{flex::toString(std::tuple_element_t<I, std::tuple<Events...>>::key).value_or("?")},
+						.pushed = m_counters.keys[I].pushed.load(std::memory_order::relaxed),
+						.handled = m_counters.keys[I].handled.load(std::memory_order::relaxed),
+						.latencyHistogram = {}
+					}), ...);
+				} (std::index_sequence_for<Events...> {});
+				for (std::size_t i {0uz}; i < sizeof...(Events); ++i) {
+					for (std::size_t bucket {0uz}; bucket < photon::events::LATENCY_BUCKET_COUNT; ++bucket) {
+						statistics.keys[i].latencyHistogram[bucket] = m_counters.keys[i].latencyHistogram[bucket]
+							.load(std::memory_order::relaxed);
+					}
+					statistics.handled += statistics.keys[i].handled;
+				}
+				if (uptime.count() > 0.0)
+					statistics.eventsPerSecond = static_cast<double> (statistics.handled) / uptime.count();
+				return statistics;
+			}
+
+			// must only be awaited from coroutines running on the scheduler passed to `serve`
+			template <Key key>
+			auto next() noexcept -> NextAwaiter<key> {
+				return NextAwaiter<key> {*this};
+			}
+			auto any() noexcept -> AnyAwaiter {
+				return AnyAwaiter{*this};
+			}
+
+			// consume the queue from the calling thread, resuming the coroutines of `scheduler` that
+			// await its events, until all of them have completed. Events nobody awaits yet are kept
+			// in order until they are
+			auto serve(photon::events::CoroutineScheduler& scheduler) noexcept -> void {
+				AwaiterVisitor visitor {.queue = *this, .scheduler = scheduler};
+				while (scheduler.hasTasks()) {
+					scheduler.runReady();
+					if (scheduler.hasReady() || !scheduler.hasTasks())
+						continue;
+					this->waitOnEvents(visitor);
+				}
+			}
+
+			auto waitOnEvent(internals::events::visitor_of_events<Key, Events...>auto& visitor) noexcept -> void {
+				this->waitOnEvents(visitor, 1uz);
+			}
+
+			// dispatch up to `maxEvents` of the already pending events without blocking. Events are
+			// served by priority, in order within a same priority. Tasks posted by senders run first
+			// and count in the returned total, but not toward `maxEvents`
+			auto drain(
+				internals::events::visitor_of_events<Key, Events...> auto& visitor,
+				std::size_t maxEvents = std::numeric_limits<std::size_t>::max()
+			) noexcept -> std::size_t {
+				const DrainCount drained {this->drainCounted(visitor, maxEvents)};
+				return drained.tasks + drained.events;
+			}
+
+			// non-blocking drain for the eventfd mode, re-arms the fd so it only becomes readable again
+			// once new events are pushed
+			auto tryDrain(
+				internals::events::visitor_of_events<Key, Events...> auto& visitor,
+				std::size_t maxEvents = std::numeric_limits<std::size_t>::max()
+			) noexcept -> std::size_t
+			requires (config.wakeup == EventQueueWakeup::eEventFd) {
+				m_signal.clear();
+				const DrainCount drained {this->drainCounted(visitor, maxEvents)};
+				// more events than `maxEvents` may be pending, keep the fd readable for the next round.
+				// Tasks don't count, they are all run in a single round
+				if (drained.events == maxEvents)
+					m_signal.notify();
+				return drained.tasks + drained.events;
+			}
+
+			// block until at least one event is pending, then drain the whole burst at once
+			auto waitOnEvents(
+				internals::events::visitor_of_events<Key, Events...> auto& visitor,
+				std::size_t maxEvents = std::numeric_limits<std::size_t>::max()
+			) noexcept -> std::size_t {
+				std::size_t count {0uz};
+				m_signal.wait([this, &visitor, &count, maxEvents] noexcept {
+					count = this->drain(visitor, maxEvents);
+					return count != 0uz;
+				});
+				return count;
+			}
+
+		private:
+			struct DrainCount {
+				std::size_t tasks;
+				std::size_t events;
+			};
+
+			constexpr BasicEventQueue() noexcept = default;
+			BasicEventQueue(std::string_view name, photon::events::Selector* selector) noexcept :
 				m_name {name},
 				m_id {},
 				m_uuid {0uz},
-				m_mutex {},
-				m_conditionalVariable {},
-				m_eventQueue {}
+				m_lanes {makeLanes()},
+				m_skipped {},
+				m_mailboxes {},
+				m_awaiters {},
+				m_anyAwaiters {},
+				m_backlog {},
+				m_tasks {},
+				m_signal {},
+				m_space {},
+				m_selector {selector},
+				m_recorder {nullptr},
+				m_recordWriters {0uz},
+				m_drops {},
+				m_counters {},
+				m_timers {}
 			{
-				static std::size_t id {0uz};
-				m_id = id++;
+				static std::atomic<std::size_t> id {0uz};
+				m_id = id.fetch_add(1uz, std::memory_order::relaxed);
 			}
-			~EventQueue() noexcept = default;
-			EventQueue(const EventQueue&) = delete;
-			auto operator=(const EventQueue&) -> EventQueue& = delete;
-			constexpr EventQueue(EventQueue&&) noexcept = default;
-			auto operator=(EventQueue&&) -> EventQueue& = delete;
 
-			constexpr auto getId() const noexcept -> std::size_t {
-				return m_id;
+			template <std::size_t>
+			static auto makeLane() noexcept -> Backend {
+				if constexpr (config.backend == EventQueueBackend::eMutex)
+					return Backend{config.capacity, config.bounded ? config.capacity : 0uz};
+				else
+					return Backend{config.capacity};
+			}
+			static auto makeLanes() noexcept -> std::array<Backend, Lanes::count> {
+				return [] <std::size_t... I> (std::index_sequence<I...>) noexcept {
+					return std::array<Backend, Lanes::count> {makeLane<I> ()...};
+				} (std::make_index_sequence<Lanes::count> {});
+			}
+
+			// returns false if the event was rejected because its lane is full
+			template <OverflowPolicy overflow>
+			auto enqueue(std::size_t lane, Slot&& slot, std::optional<Entry>& evicted) noexcept -> bool {
+				Entry entry {[&slot] () noexcept {
+					if constexpr (config.instrumentation)
+						return Entry{.slot = std::move(slot), .pushedAt = std::chrono::steady_clock::now()};
+					else
+						return Entry{.slot = std::move(slot)};
+				} ()};
+				if constexpr (config.instrumentation)
+					m_counters.onEnqueue();
+				if constexpr (!IS_BOUNDED)
+					m_lanes[lane].push(std::move(entry));
+				else if constexpr (overflow == OverflowPolicy::eBlock) {
+					m_space.wait([this, lane, &entry] noexcept {
+						return m_lanes[lane].tryPush(std::move(entry));
+					});
+				}
+				else if constexpr (overflow == OverflowPolicy::eDropOldest)
+					// a coalescing event is taken out of its mailbox along with its marker, otherwise a
+					// producer could still overwrite it in between and have its value silently lost
+					evicted = m_lanes[lane].pushEvicting(std::move(entry), [this] (Entry& evictedEntry) noexcept {
+						evictedEntry.slot.visit([this] (auto& event) noexcept {
+							this->forget(event);
+						});
+					});
+				else if (!m_lanes[lane].tryPush(std::move(entry))) {
+					if constexpr (config.instrumentation)
+						m_counters.onEvict();
+					return false;
+				}
+				m_signal.notify();
+				if (m_selector != nullptr)
+					m_selector->notify();
+				return true;
+			}
+
+			// null when no recording is running
+			template <Key key>
+			auto serialize(const value_from_key<key>& value) const noexcept -> const std::vector<std::byte>*
+			requires (config.recording) {
+				if (m_recorder.load(std::memory_order::relaxed) == nullptr)
+					return nullptr;
+				// reused across pushes so that recording doesn't allocate in the steady state
+				static thread_local std::vector<std::byte> payload {};
+				payload.clear();
+				photon::events::Serializer<value_from_key<key>>::write(value, payload);
+				return &payload;
 			}
 
 			template <Key key>
-			auto push(flex::forward_of<value_from_key<key>> auto&& value) noexcept -> void {
+			auto record(std::size_t uuid, const std::vector<std::byte>* payload) noexcept -> void {
+				if constexpr (config.recording) {
+					if (payload == nullptr)
+						return;
+					// announced before loading the recorder, so that `stopRecording` either sees this
+					// writer or makes it see no recorder at all
+					m_recordWriters.fetch_add(1uz, std::memory_order::seq_cst);
+					if (auto recorder {m_recorder.load(std::memory_order::seq_cst)}; recorder != nullptr)
+						recorder->record(static_cast<std::int64_t> (std::to_underlying(key)), uuid, *payload);
+					m_recordWriters.fetch_sub(1uz, std::memory_order::release);
+				}
+			}
+
+			auto post(internals::events::TaskNode& task) noexcept -> void {
+				m_tasks.push(task);
+				m_signal.notify();
+				if (m_selector != nullptr)
+					m_selector->notify();
+			}
+
+			auto evict(const Entry& entry) noexcept -> void {
+				m_drops[entry.slot.index()].fetch_add(1u, std::memory_order::relaxed);
+				if constexpr (config.instrumentation)
+					m_counters.onEvict();
+			}
+			// called under the lock of the lane, which is why producers never enqueue while holding a
+			// mailbox lock
+			auto forget(internals::events::event_of_key<Key> auto&) noexcept -> void {}
+			template <std::size_t index>
+			auto forget(internals::events::CoalescedEvent<index>&) noexcept -> void {
+				auto& mailbox {std::get<index> (m_mailboxes)};
+				std::scoped_lock<std::mutex> _ {mailbox.mutex};
+				mailbox.event.reset();
+			}
+
+			auto dispatch(internals::events::event_of_key<Key> auto& event, auto& visitor) noexcept -> void {
+				visitor.handle(std::move(event));
+			}
+			template <std::size_t index>
+			auto dispatch(internals::events::CoalescedEvent<index>&, auto& visitor) noexcept -> void {
+				auto& mailbox {std::get<index> (m_mailboxes)};
+				std::optional<std::tuple_element_t<index, std::tuple<Events...>>> event {};
 				{
-					std::scoped_lock<std::mutex> _ {m_mutex};
-					m_eventQueue.push(std::make_unique<Event<key, value_from_key<key>>> (
-						m_id, m_uuid++, std::forward<decltype(value)> (value)
-					));
+					std::scoped_lock<std::mutex> _ {mailbox.mutex};
+					event = std::move(mailbox.event);
+					mailbox.event.reset();
 				}
-				m_conditionalVariable.notify_one();
+				visitor.handle(std::move(*event));
 			}
 
-			auto waitOnEvent(internals::events::visitor_of_events<Key, Events...>auto& visitor) noexcept -> void {
-				std::unique_lock<std::mutex> lock {m_mutex};
-				m_conditionalVariable.wait(lock, [this]{return m_eventQueue.size() != 0uz;});
-				std::unique_ptr<EventBase<Key>> event {std::move(m_eventQueue.front())};
-				m_eventQueue.pop();
-				[&event, &visitor] <std::size_t I = 0> (this const auto& self) {
-					static constexpr Key eventKey {internals::events::get_event_key<Key, Events...[I]>::value};
-					if (event->key == eventKey) {
-						return visitor.handle(
-							std::move(static_cast<Event<eventKey, value_from_key<eventKey>>&> (*event))
-						);
+			struct AwaiterVisitor {
+				BasicEventQueue& queue;
+				photon::events::CoroutineScheduler& scheduler;
+
+				template <internals::events::event_of_key<Key> EventType>
+				auto handle(EventType event) noexcept -> void {
+					queue.deliver(std::move(event), scheduler);
+				}
+			};
+
+			template <typename EventType>
+			auto deliver(EventType&& event, photon::events::CoroutineScheduler& scheduler) noexcept -> void {
+				static constexpr std::size_t index {index_from_key<EventType::key>};
+				if (auto node {m_awaiters[index].pop()}; node != nullptr) {
+					auto& awaiter {static_cast<NextAwaiter<EventType::key>&> (*node)};
+					awaiter.m_event.emplace(std::move(event));
+					return scheduler.schedule(awaiter.handle);
+				}
+				if (auto node {m_anyAwaiters.pop()}; node != nullptr) {
+					auto& awaiter {static_cast<AnyAwaiter&> (*node)};
+					awaiter.m_event.emplace(std::in_place_index<index>, std::move(event));
+					return scheduler.schedule(awaiter.handle);
+				}
+				m_backlog.emplace_back(std::in_place_index<index>, std::move(event));
+			}
+
+			// one scheduling round : first a single event from every lower lane that was passed over
+			// `starvationLimit` times, then a batch from the highest non-empty lane
+			auto drainCounted(
+				internals::events::visitor_of_events<Key, Events...> auto& visitor,
+				std::size_t maxEvents
+			) noexcept -> DrainCount {
+				const auto dispatch {[this, &visitor] (Entry&& entry) noexcept {
+					if constexpr (config.instrumentation)
+						m_counters.onHandle(entry.slot.index(), std::chrono::steady_clock::now() - entry.pushedAt);
+					entry.slot.visit([this, &visitor] (auto& event) noexcept {
+						this->dispatch(event, visitor);
+					});
+				}};
+				const std::size_t tasks {m_tasks.run()};
+				std::size_t count {0uz};
+				if constexpr (Lanes::count == 1uz)
+					count = m_lanes[0].drain(dispatch, maxEvents);
+				else {
+					while (count < maxEvents) {
+						const std::size_t served {this->drainLanes(dispatch, maxEvents - count)};
+						if (served == 0uz)
+							break;
+						count += served;
 					}
-					if constexpr (I + 1 < sizeof...(Events))
-						self.template operator() <I + 1> ();
-				} ();
+				}
+				if constexpr (IS_BOUNDED) {
+					if (count != 0uz)
+						m_space.notifyAll();
+				}
+				return DrainCount{.tasks = tasks, .events = count};
 			}
 
-		private:
-			constexpr EventQueue() noexcept = default;
+			auto drainLanes(auto& dispatch, std::size_t maxEvents) noexcept -> std::size_t {
+				std::size_t count {0uz};
+				for (std::size_t lane {Lanes::count - 1uz}; lane > 0uz && count < maxEvents; --lane) {
+					if (m_skipped[lane] < config.starvationLimit)
+						continue;
+					m_skipped[lane] = 0uz;
+					count += m_lanes[lane].drain(dispatch, 1uz);
+				}
+				for (std::size_t lane {0uz}; lane < Lanes::count && count < maxEvents; ++lane) {
+					const std::size_t served {m_lanes[lane].drain(
+						dispatch, std::min(config.starvationLimit, maxEvents - count)
+					)};
+					if (served == 0uz)
+						continue;
+					for (std::size_t lower {lane + 1uz}; lower < Lanes::count; ++lower)
+						m_skipped[lower] += served;
+					count += served;
+					break;
+				}
+				return count;
+			}
 
 			std::string m_name;
 			std::size_t m_id;
-			std::size_t m_uuid;
-			std::mutex m_mutex;
-			std::condition_variable m_conditionalVariable;
-			std::queue<std::unique_ptr<EventBase<Key>>> m_eventQueue;
+			std::atomic<std::size_t> m_uuid;
+			std::array<Backend, Lanes::count> m_lanes;
+			// consumer-only, number of events served from higher lanes since each lane was last served
+			std::array<std::size_t, Lanes::count> m_skipped;
+			std::tuple<internals::events::mailbox_of<Events>...> m_mailboxes;
+			// coroutine side, only touched by the thread serving the queue
+			std::array<internals::events::AwaiterList, sizeof...(Events)> m_awaiters;
+			internals::events::AwaiterList m_anyAwaiters;
+			std::deque<std::variant<Events...>> m_backlog;
+			internals::events::TaskList m_tasks;
+			Signal m_signal;
+			// woken by the consumer after each drain, for the producers blocked on a full lane
+			photon::events::Signal m_space;
+			photon::events::Selector* m_selector;
+			std::atomic<photon::events::EventRecorder*> m_recorder;
+			// producers between loading `m_recorder` and being done with it
+			std::atomic<std::size_t> m_recordWriters;
+			std::array<std::atomic<std::uint64_t>, sizeof...(Events)> m_drops;
+			[[no_unique_address]] Counters m_counters;
+			// last so that its thread stops pushing before the rest of the queue is destroyed
+			photon::events::TimerWheel m_timers;
 	};
+
+	template <event_key Key, internals::events::event_of_key<Key>... Events>
+	using EventQueue = BasicEventQueue<EventQueueConfig{}, Key, Events...>;
 }
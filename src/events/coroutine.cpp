@@ -0,0 +1,37 @@
+#include "events/coroutine.hpp"
+
+#include <algorithm>
+
+
+namespace photon::events {
+	CoroutineScheduler::~CoroutineScheduler() noexcept {
+		for (const auto task : m_tasks)
+			task.destroy();
+	}
+
+	auto CoroutineScheduler::spawn(Task&& task) noexcept -> void {
+		const auto handle {task.release()};
+		m_tasks.push_back(handle);
+		m_ready.push_back(handle);
+	}
+
+	auto CoroutineScheduler::schedule(std::coroutine_handle<> handle) noexcept -> void {
+		m_ready.push_back(handle);
+	}
+
+	auto CoroutineScheduler::runReady() noexcept -> std::size_t {
+		m_running.clear();
+		std::swap(m_running, m_ready);
+		for (const auto handle : m_running)
+			handle.resume();
+
+		const auto finished {std::ranges::remove_if(m_tasks, [] (const auto task) noexcept {
+			if (!task.done())
+				return false;
+			task.destroy();
+			return true;
+		})};
+		m_tasks.erase(finished.begin(), finished.end());
+		return m_running.size();
+	}
+}
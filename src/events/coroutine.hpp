@@ -0,0 +1,76 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+#include <vector>
+
+
+namespace photon::events {
+	// fire-and-forget coroutine, owned by the `CoroutineScheduler` it is spawned on
+	class Task final {
+		public:
+			struct promise_type {
+				auto get_return_object() noexcept -> Task {
+					return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+				}
+				auto initial_suspend() noexcept -> std::suspend_always {return {};}
+				auto final_suspend() noexcept -> std::suspend_always {return {};}
+				auto return_void() noexcept -> void {}
+				auto unhandled_exception() noexcept -> void {std::terminate();}
+			};
+
+			~Task() noexcept {
+				if (m_handle)
+					m_handle.destroy();
+			}
+			Task(const Task&) = delete;
+			auto operator=(const Task&) -> Task& = delete;
+			Task(Task&& other) noexcept :
+				m_handle {std::exchange(other.m_handle, nullptr)}
+			{}
+			auto operator=(Task&&) -> Task& = delete;
+
+			auto release() noexcept -> std::coroutine_handle<promise_type> {
+				return std::exchange(m_handle, nullptr);
+			}
+
+		private:
+			explicit Task(std::coroutine_handle<promise_type> handle) noexcept :
+				m_handle {handle}
+			{}
+
+			std::coroutine_handle<promise_type> m_handle;
+	};
+
+
+	// runs many `Task`s on the thread calling `runReady`. Coroutines suspended on an event queue
+	// don't own any thread, they are only made ready again by the queue serving this scheduler
+	class CoroutineScheduler final {
+		public:
+			CoroutineScheduler() noexcept = default;
+			~CoroutineScheduler() noexcept;
+			CoroutineScheduler(const CoroutineScheduler&) = delete;
+			auto operator=(const CoroutineScheduler&) -> CoroutineScheduler& = delete;
+			CoroutineScheduler(CoroutineScheduler&&) = delete;
+			auto operator=(CoroutineScheduler&&) -> CoroutineScheduler& = delete;
+
+			auto spawn(Task&& task) noexcept -> void;
+			auto schedule(std::coroutine_handle<> handle) noexcept -> void;
+			// resume every ready coroutine, the ones made ready meanwhile wait for the next call
+			auto runReady() noexcept -> std::size_t;
+
+			inline auto hasTasks() const noexcept -> bool {
+				return !m_tasks.empty();
+			}
+			inline auto hasReady() const noexcept -> bool {
+				return !m_ready.empty();
+			}
+
+		private:
+			std::vector<std::coroutine_handle<Task::promise_type>> m_tasks;
+			std::vector<std::coroutine_handle<>> m_ready;
+			std::vector<std::coroutine_handle<>> m_running;
+	};
+}
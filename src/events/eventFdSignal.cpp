@@ -0,0 +1,46 @@
+#include "events/eventFdSignal.hpp"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+
+namespace photon::events {
+	EventFdSignal::EventFdSignal() noexcept :
+		m_fd {eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)},
+		m_pending {false}
+	{
+		assert(m_fd >= 0 && "Can't create eventfd for event queue");
+	}
+
+	EventFdSignal::~EventFdSignal() noexcept {
+		if (m_fd >= 0)
+			close(m_fd);
+	}
+
+	auto EventFdSignal::clear() noexcept -> void {
+		// the read must happen before `m_pending` is reset : a producer that sees `m_pending` still
+		// set skips its write, so the fd may only go idle while the consumer is about to drain
+		std::uint64_t count {};
+		while (read(m_fd, &count, sizeof(count)) < 0 && errno == EINTR);
+		m_pending.exchange(false, std::memory_order::acq_rel);
+	}
+
+	auto EventFdSignal::wake() noexcept -> void {
+		const std::uint64_t count {1u};
+		while (write(m_fd, &count, sizeof(count)) < 0 && errno == EINTR);
+	}
+
+	auto EventFdSignal::park() noexcept -> void {
+		pollfd pollFd {
+			.fd = m_fd,
+			.events = POLLIN,
+			.revents = 0
+		};
+		while (poll(&pollFd, 1, -1) < 0 && errno == EINTR);
+	}
+}
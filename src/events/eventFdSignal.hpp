@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+
+
+namespace photon::events {
+	// same contract as `photon::events::Signal`, but the wakeup goes through an eventfd that the
+	// owner can hand to poll/epoll along with its other file descriptors. Producers only issue the
+	// `write` when the fd goes from idle to readable
+	class EventFdSignal final {
+		public:
+			EventFdSignal() noexcept;
+			~EventFdSignal() noexcept;
+			EventFdSignal(const EventFdSignal&) = delete;
+			auto operator=(const EventFdSignal&) -> EventFdSignal& = delete;
+			EventFdSignal(EventFdSignal&&) = delete;
+			auto operator=(EventFdSignal&&) -> EventFdSignal& = delete;
+
+			inline auto notify() noexcept -> void {
+				if (!m_pending.exchange(true, std::memory_order::acq_rel))
+					this->wake();
+			}
+
+			// make the fd idle again, must be called by the consumer before it looks for work
+			auto clear() noexcept -> void;
+
+			template <std::predicate Predicate>
+			auto wait(Predicate&& ready) noexcept -> void {
+				while (true) {
+					this->clear();
+					if (ready())
+						return;
+					this->park();
+				}
+			}
+
+			inline auto getFd() const noexcept -> int {
+				return m_fd;
+			}
+
+		private:
+			auto wake() noexcept -> void;
+			auto park() noexcept -> void;
+
+			int m_fd;
+			std::atomic<bool> m_pending;
+	};
+}
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+
+namespace photon::internals::events {
+	// unit of work posted to an event queue, run by its consumer thread
+	struct TaskNode {
+		TaskNode* next;
+		void (*execute)(TaskNode&) noexcept;
+	};
+
+	// intrusive multi-producer stack, reversed by the consumer so that tasks run in posting order.
+	// Posting never allocates, the node lives in the operation state of the sender
+	class TaskList final {
+		public:
+			constexpr TaskList() noexcept = default;
+			~TaskList() noexcept = default;
+			TaskList(const TaskList&) = delete;
+			auto operator=(const TaskList&) -> TaskList& = delete;
+			TaskList(TaskList&&) = delete;
+			auto operator=(TaskList&&) -> TaskList& = delete;
+
+			auto push(TaskNode& node) noexcept -> void {
+				node.next = m_head.load(std::memory_order::relaxed);
+				while (!m_head.compare_exchange_weak(node.next, &node, std::memory_order::release, std::memory_order::relaxed));
+			}
+
+			// must only be called from the consumer thread
+			auto run() noexcept -> std::size_t {
+				TaskNode* node {m_head.exchange(nullptr, std::memory_order::acquire)};
+				TaskNode* ordered {nullptr};
+				while (node != nullptr)
+					ordered = std::exchange(node, std::exchange(node->next, ordered));
+				std::size_t count {0uz};
+				while (ordered != nullptr) {
+					// the task may destroy its own node
+					TaskNode* next {ordered->next};
+					ordered->execute(*ordered);
+					ordered = next;
+					++count;
+				}
+				return count;
+			}
+
+		private:
+			std::atomic<TaskNode*> m_head {nullptr};
+	};
+
+
+	template <typename T>
+	using value_or_monostate = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+	template <typename Sender, typename Receiver>
+	using connect_result_t = decltype(std::declval<Sender> ().connect(std::declval<Receiver> ()));
+
+	template <typename Function, typename Value>
+	struct then_result {
+		using type = std::invoke_result_t<Function, Value>;
+	};
+	template <typename Function>
+	struct then_result<Function, void> {
+		using type = std::invoke_result_t<Function>;
+	};
+
+	template <typename Function, typename Receiver>
+	struct ThenReceiver {
+		Function function;
+		Receiver receiver;
+
+		auto setValue(auto&&... values) noexcept -> void {
+			using Result = std::invoke_result_t<Function, decltype(values)...>;
+			if constexpr (std::is_void_v<Result>) {
+				std::invoke(std::move(function), std::forward<decltype(values)> (values)...);
+				receiver.setValue();
+			}
+			else
+				receiver.setValue(std::invoke(std::move(function), std::forward<decltype(values)> (values)...));
+		}
+	};
+
+	template <typename Operation, std::size_t index>
+	struct WhenAllReceiver {
+		Operation* operation;
+
+		auto setValue(auto&&... values) noexcept -> void {
+			operation->template complete<index> (std::forward<decltype(values)> (values)...);
+		}
+	};
+
+	// operation states of the children, each built in place from its sender
+	template <typename Operation, std::size_t index, typename... Senders>
+	struct WhenAllChildren {
+		constexpr WhenAllChildren(Operation*) noexcept {}
+		auto start() noexcept -> void {}
+	};
+	template <typename Operation, std::size_t index, typename Sender, typename... Senders>
+	struct WhenAllChildren<Operation, index, Sender, Senders...> {
+		WhenAllChildren(Operation* operation, Sender&& sender, Senders&&... senders) noexcept :
+			child {std::move(sender).connect(WhenAllReceiver<Operation, index> {operation})},
+			rest {operation, std::move(senders)...}
+		{}
+		auto start() noexcept -> void {
+			child.start();
+			rest.start();
+		}
+
+		connect_result_t<Sender, WhenAllReceiver<Operation, index>> child;
+		WhenAllChildren<Operation, index + 1uz, Senders...> rest;
+	};
+
+	template <typename Receiver, typename... Senders>
+	class WhenAllOperation final {
+		template <typename, std::size_t>
+		friend struct WhenAllReceiver;
+		using Values = std::tuple<value_or_monostate<typename Senders::value_type>...>;
+		public:
+			WhenAllOperation(std::tuple<Senders...>&& senders, Receiver&& receiver) noexcept :
+				m_receiver {std::move(receiver)},
+				m_values {},
+				m_remaining {sizeof...(Senders)},
+				m_children {std::apply([this] (Senders&... senders) noexcept {
+					return WhenAllChildren<WhenAllOperation, 0uz, Senders...> {this, std::move(senders)...};
+				}, senders)}
+			{}
+			WhenAllOperation(const WhenAllOperation&) = delete;
+			auto operator=(const WhenAllOperation&) -> WhenAllOperation& = delete;
+			WhenAllOperation(WhenAllOperation&&) = delete;
+			auto operator=(WhenAllOperation&&) -> WhenAllOperation& = delete;
+
+			auto start() noexcept -> void {
+				m_children.start();
+			}
+
+		private:
+			template <std::size_t index>
+			auto complete(auto&&... values) noexcept -> void {
+				if constexpr (sizeof...(values) != 0uz)
+					std::get<index> (m_values).emplace(std::forward<decltype(values)> (values)...);
+				else
+					std::get<index> (m_values).emplace();
+				// the children may complete on different threads, the last one forwards the values
+				if (m_remaining.fetch_sub(1uz, std::memory_order::acq_rel) != 1uz)
+					return;
+				m_receiver.setValue(std::apply([] (auto&... values) noexcept {
+					return Values{std::move(*values)...};
+				}, m_values));
+			}
+
+			Receiver m_receiver;
+			std::tuple<std::optional<value_or_monostate<typename Senders::value_type>>...> m_values;
+			std::atomic<std::size_t> m_remaining;
+			WhenAllChildren<WhenAllOperation, 0uz, Senders...> m_children;
+	};
+
+	template <typename Sender>
+	class DetachedOperation final {
+		struct Receiver {
+			DetachedOperation* operation;
+
+			auto setValue(auto&&...) noexcept -> void {
+				delete operation;
+			}
+		};
+
+		public:
+			DetachedOperation(Sender sender) noexcept :
+				m_operation {std::move(sender).connect(Receiver{this})}
+			{}
+
+			auto start() noexcept -> void {
+				m_operation.start();
+			}
+
+		private:
+			connect_result_t<Sender, Receiver> m_operation;
+	};
+}
+
+
+// minimal sender/receiver model in the spirit of P2300, until `std::execution` ships with the
+// toolchain. Senders complete with at most one value, through `setValue` on their receiver, and
+// their operation states must stay in place once started
+namespace photon::events {
+	template <typename Sender>
+	concept sender = std::move_constructible<std::remove_cvref_t<Sender>>
+		&& requires { typename std::remove_cvref_t<Sender>::value_type; };
+
+	template <typename Receiver, typename Value>
+	concept receiver_of = std::move_constructible<Receiver>
+		&& (std::is_void_v<Value>
+			? requires(Receiver receiver) {{receiver.setValue()} noexcept;}
+			: requires(Receiver receiver, internals::events::value_or_monostate<Value>&& value) {
+				{receiver.setValue(std::move(value))} noexcept;
+			}
+		);
+
+
+	// sender that completes on the consumer thread of `Queue`
+	template <typename Queue>
+	class QueueScheduler final {
+		public:
+			template <typename Receiver>
+			class Operation final : internals::events::TaskNode {
+				friend QueueScheduler;
+				public:
+					Operation(const Operation&) = delete;
+					auto operator=(const Operation&) -> Operation& = delete;
+					Operation(Operation&&) = delete;
+					auto operator=(Operation&&) -> Operation& = delete;
+
+					auto start() noexcept -> void {
+						m_queue->post(*this);
+					}
+
+				private:
+					Operation(Queue& queue, Receiver&& receiver) noexcept :
+						internals::events::TaskNode {.next = nullptr, .execute = &Operation::execute},
+						m_queue {&queue},
+						m_receiver {std::move(receiver)}
+					{}
+
+					static auto execute(internals::events::TaskNode& node) noexcept -> void {
+						static_cast<Operation&> (node).m_receiver.setValue();
+					}
+
+					Queue* m_queue;
+					Receiver m_receiver;
+			};
+
+			class Sender final {
+				public:
+					using value_type = void;
+
+					template <receiver_of<void> Receiver>
+					auto connect(Receiver receiver) && noexcept -> Operation<Receiver> {
+						return Operation<Receiver> {*m_queue, std::move(receiver)};
+					}
+
+				private:
+					friend QueueScheduler;
+					constexpr Sender(Queue& queue) noexcept : m_queue {&queue} {}
+					Queue* m_queue;
+			};
+
+			constexpr QueueScheduler(Queue& queue) noexcept : m_queue {&queue} {}
+
+			auto schedule() const noexcept -> Sender {
+				return Sender{*m_queue};
+			}
+
+			constexpr auto operator==(const QueueScheduler&) const noexcept -> bool = default;
+
+		private:
+			Queue* m_queue;
+	};
+
+	template <typename Scheduler>
+	auto schedule(const Scheduler& scheduler) noexcept {
+		return scheduler.schedule();
+	}
+
+
+	template <sender Sender, typename Function>
+	class ThenSender final {
+		public:
+			using value_type = typename internals::events::then_result<Function, typename Sender::value_type>::type;
+
+			ThenSender(Sender sender, Function function) noexcept :
+				m_sender {std::move(sender)},
+				m_function {std::move(function)}
+			{}
+
+			template <receiver_of<value_type> Receiver>
+			auto connect(Receiver receiver) && noexcept {
+				return std::move(m_sender).connect(internals::events::ThenReceiver<Function, Receiver> {
+					.function = std::move(m_function),
+					.receiver = std::move(receiver)
+				});
+			}
+
+		private:
+			Sender m_sender;
+			Function m_function;
+	};
+
+	// complete with the result of `function` called on the value of `sender`, on the same thread
+	template <sender Sender, typename Function>
+	auto then(Sender&& sender, Function&& function) noexcept -> ThenSender<std::remove_cvref_t<Sender>, std::remove_cvref_t<Function>> {
+		return {std::forward<Sender> (sender), std::forward<Function> (function)};
+	}
+
+	template <typename Function>
+	struct ThenClosure {
+		Function function;
+
+		template <sender Sender>
+		friend auto operator|(Sender&& sender, ThenClosure&& closure) noexcept {
+			return photon::events::then(std::forward<Sender> (sender), std::move(closure.function));
+		}
+	};
+
+	// `sender | then(function)`
+	template <typename Function>
+	auto then(Function&& function) noexcept -> ThenClosure<std::remove_cvref_t<Function>> {
+		return {std::forward<Function> (function)};
+	}
+
+
+	template <sender... Senders>
+	class WhenAllSender final {
+		public:
+			using value_type = std::tuple<internals::events::value_or_monostate<typename Senders::value_type>...>;
+
+			WhenAllSender(Senders... senders) noexcept :
+				m_senders {std::move(senders)...}
+			{}
+
+			template <receiver_of<value_type> Receiver>
+			auto connect(Receiver receiver) && noexcept -> internals::events::WhenAllOperation<Receiver, Senders...> {
+				return internals::events::WhenAllOperation<Receiver, Senders...> {std::move(m_senders), std::move(receiver)};
+			}
+
+		private:
+			std::tuple<Senders...> m_senders;
+	};
+
+	// complete once every sender did, with a tuple of their values, `std::monostate` standing for
+	// senders that complete without one. Completes on the thread of the last sender to finish
+	template <sender... Senders>
+	requires (sizeof...(Senders) > 0uz)
+	auto whenAll(Senders&&... senders) noexcept -> WhenAllSender<std::remove_cvref_t<Senders>...> {
+		return {std::forward<Senders> (senders)...};
+	}
+
+
+	// start `sender` without waiting for it, its operation state frees itself on completion
+	template <sender Sender>
+	auto startDetached(Sender&& sender) noexcept -> void {
+		auto* operation {new internals::events::DetachedOperation<std::remove_cvref_t<Sender>> {std::forward<Sender> (sender)}};
+		operation->start();
+	}
+}
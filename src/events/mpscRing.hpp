@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "utils/utils.hpp"
+
+
+namespace photon::events {
+	// bounded multi-producer / single-consumer ring. Each cell carries a sequence number telling
+	// whether it is free for the producers of the current lap or published for the consumer, so
+	// producers only contend on the tail CAS and the consumer never takes a lock
+	template <typename T>
+	requires std::is_nothrow_move_constructible_v<T>
+	class MpscRing final {
+		struct Cell {
+			std::atomic<std::size_t> sequence;
+			alignas(T) std::byte storage[sizeof(T)];
+		};
+
+		public:
+			MpscRing(std::size_t capacity) noexcept :
+				m_mask {std::bit_ceil(capacity < 2uz ? 2uz : capacity) - 1uz},
+				m_cells {std::make_unique<Cell[]> (m_mask + 1uz)},
+				m_tail {0uz},
+				m_head {0uz}
+			{
+				for (std::size_t i {0uz}; i <= m_mask; ++i)
+					m_cells[i].sequence.store(i, std::memory_order::relaxed);
+			}
+			~MpscRing() noexcept {
+				while (this->tryPop());
+			}
+			MpscRing(const MpscRing&) = delete;
+			auto operator=(const MpscRing&) -> MpscRing& = delete;
+			MpscRing(MpscRing&&) = delete;
+			auto operator=(MpscRing&&) -> MpscRing& = delete;
+
+			constexpr auto capacity() const noexcept -> std::size_t {
+				return m_mask + 1uz;
+			}
+
+			// `value` is left untouched if the ring is full. Producers never block each other, a full
+			// ring is handled by the overflow policy of the event queue
+			auto tryPush(T&& value) noexcept -> bool {
+				std::size_t position {m_tail.load(std::memory_order::relaxed)};
+				Cell* cell {nullptr};
+				while (true) {
+					cell = &m_cells[position & m_mask];
+					const std::size_t sequence {cell->sequence.load(std::memory_order::acquire)};
+					const auto difference {static_cast<std::intptr_t> (sequence) - static_cast<std::intptr_t> (position)};
+					if (difference == 0) {
+						if (m_tail.compare_exchange_weak(position, position + 1uz, std::memory_order::relaxed))
+							break;
+					}
+					else if (difference < 0)
+						return false;
+					else
+						position = m_tail.load(std::memory_order::relaxed);
+				}
+				new (cell->storage) T(std::move(value));
+				cell->sequence.store(position + 1uz, std::memory_order::release);
+				return true;
+			}
+
+			// must only be called from the consumer thread
+			auto tryPop() noexcept -> std::optional<T> {
+				Cell& cell {m_cells[m_head & m_mask]};
+				if (cell.sequence.load(std::memory_order::acquire) != m_head + 1uz)
+					return std::nullopt;
+				T* element {std::launder(reinterpret_cast<T*> (cell.storage))};
+				std::optional<T> value {std::move(*element)};
+				element->~T();
+				cell.sequence.store(m_head + m_mask + 1uz, std::memory_order::release);
+				++m_head;
+				return value;
+			}
+
+			// must only be called from the consumer thread
+			template <typename Callback>
+			auto drain(Callback&& callback, std::size_t maxCount) noexcept -> std::size_t {
+				std::size_t count {0uz};
+				for (; count < maxCount; ++count) {
+					auto value {this->tryPop()};
+					if (!value)
+						break;
+					callback(std::move(*value));
+				}
+				return count;
+			}
+
+		private:
+			const std::size_t m_mask;
+			std::unique_ptr<Cell[]> m_cells;
+			alignas(photon::utils::CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail;
+			alignas(photon::utils::CACHE_LINE_SIZE) std::size_t m_head;
+	};
+}
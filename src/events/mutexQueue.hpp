@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace photon::events {
+	// FIFO guarded by a single mutex, unbounded unless `maxSize` is given. The elements live in a
+	// circular buffer that only ever grows, so once it reached the peak depth pushing and popping
+	// never touch the allocator. The consumer owns a second buffer that it swaps with the
+	// producers' one to drain in bulk
+	template <typename T>
+	requires std::default_initializable<T> && std::is_nothrow_move_assignable_v<T>
+	class MutexQueue final {
+		public:
+			MutexQueue(std::size_t initialCapacity, std::size_t maxSize = 0uz) noexcept :
+				m_mutex {},
+				m_buffer {},
+				m_head {0uz},
+				m_size {0uz},
+				m_maxSize {maxSize},
+				m_drainBuffer {}
+			{
+				if (m_maxSize != 0uz)
+					initialCapacity = std::min(initialCapacity, m_maxSize);
+				m_buffer.resize(initialCapacity < 1uz ? 1uz : initialCapacity);
+				m_drainBuffer.resize(m_buffer.size());
+			}
+			~MutexQueue() noexcept = default;
+			MutexQueue(const MutexQueue&) = delete;
+			auto operator=(const MutexQueue&) -> MutexQueue& = delete;
+			MutexQueue(MutexQueue&&) = delete;
+			auto operator=(MutexQueue&&) -> MutexQueue& = delete;
+
+			auto push(T&& value) noexcept -> void {
+				std::scoped_lock<std::mutex> _ {m_mutex};
+				this->pushLocked(std::move(value));
+			}
+
+			// `value` is left untouched if the queue is full
+			auto tryPush(T&& value) noexcept -> bool {
+				std::scoped_lock<std::mutex> _ {m_mutex};
+				if (m_maxSize != 0uz && m_size == m_maxSize)
+					return false;
+				this->pushLocked(std::move(value));
+				return true;
+			}
+
+			// make room by evicting the oldest element if the queue is full. `evicting` is called on it
+			// under the lock, then it is returned so that it gets destroyed outside of it
+			template <std::invocable<T&> Evicting>
+			auto pushEvicting(T&& value, Evicting&& evicting) noexcept -> std::optional<T> {
+				std::optional<T> evicted {};
+				std::scoped_lock<std::mutex> _ {m_mutex};
+				if (m_maxSize != 0uz && m_size == m_maxSize) {
+					evicted.emplace(std::move(m_buffer[m_head]));
+					std::invoke(std::forward<Evicting> (evicting), *evicted);
+					m_head = (m_head + 1uz) % m_buffer.size();
+					--m_size;
+				}
+				this->pushLocked(std::move(value));
+				return evicted;
+			}
+
+			auto tryPop() noexcept -> std::optional<T> {
+				std::scoped_lock<std::mutex> _ {m_mutex};
+				if (m_size == 0uz)
+					return std::nullopt;
+				std::optional<T> value {std::move(m_buffer[m_head])};
+				m_head = (m_head + 1uz) % m_buffer.size();
+				--m_size;
+				return value;
+			}
+
+			// pop at most `maxCount` elements under a single lock acquisition, then hand them to
+			// `callback` in order once the lock is released. Must only be called from the consumer
+			template <typename Callback>
+			auto drain(Callback&& callback, std::size_t maxCount) noexcept -> std::size_t {
+				std::size_t head {0uz};
+				std::size_t count {0uz};
+				{
+					std::scoped_lock<std::mutex> _ {m_mutex};
+					count = std::min(m_size, maxCount);
+					if (count == 0uz)
+						return 0uz;
+					if (count == m_size) {
+						std::swap(m_buffer, m_drainBuffer);
+						head = std::exchange(m_head, 0uz);
+						m_size = 0uz;
+					}
+					else {
+						if (m_drainBuffer.size() < count)
+							m_drainBuffer.resize(count);
+						for (std::size_t i {0uz}; i < count; ++i)
+							m_drainBuffer[i] = std::move(m_buffer[(m_head + i) % m_buffer.size()]);
+						m_head = (m_head + count) % m_buffer.size();
+						m_size -= count;
+					}
+				}
+				for (std::size_t i {0uz}; i < count; ++i)
+					callback(std::move(m_drainBuffer[(head + i) % m_drainBuffer.size()]));
+				return count;
+			}
+
+		private:
+			auto pushLocked(T&& value) noexcept -> void {
+				if (m_size == m_buffer.size())
+					this->grow();
+				m_buffer[(m_head + m_size) % m_buffer.size()] = std::move(value);
+				++m_size;
+			}
+
+			auto grow() noexcept -> void {
+				std::vector<T> buffer {};
+				buffer.resize(m_maxSize == 0uz ? m_buffer.size() * 2uz : std::min(m_buffer.size() * 2uz, m_maxSize));
+				for (std::size_t i {0uz}; i < m_size; ++i)
+					buffer[i] = std::move(m_buffer[(m_head + i) % m_buffer.size()]);
+				m_buffer = std::move(buffer);
+				m_head = 0uz;
+			}
+
+			std::mutex m_mutex;
+			std::vector<T> m_buffer;
+			std::size_t m_head;
+			std::size_t m_size;
+			const std::size_t m_maxSize;
+			std::vector<T> m_drainBuffer;
+	};
+}
@@ -0,0 +1,120 @@
+#include "events/record.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <utility>
+
+
+namespace photon::events {
+	static constexpr std::array<char, 8> LOG_MAGIC {'P', 'H', 'E', 'V', 'L', 'O', 'G', '\x01'};
+	static constexpr std::size_t MAX_VARINT_SIZE {10uz};
+
+	static auto writeVarint(std::uint64_t value, std::byte* output) noexcept -> std::size_t {
+		std::size_t size {0uz};
+		while (value >= 0x80u) {
+			output[size++] = static_cast<std::byte> ((value & 0x7fu) | 0x80u);
+			value >>= 7u;
+		}
+		output[size++] = static_cast<std::byte> (value);
+		return size;
+	}
+
+	static auto readVarint(std::FILE* file) noexcept -> std::optional<std::uint64_t> {
+		std::uint64_t value {0u};
+		for (std::uint32_t shift {0u}; shift < 64u; shift += 7u) {
+			const int byte {std::fgetc(file)};
+			if (byte == EOF)
+				return std::nullopt;
+			value |= static_cast<std::uint64_t> (byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+		return std::nullopt;
+	}
+
+
+	EventRecorder::~EventRecorder() noexcept {
+		if (m_file != nullptr)
+			std::fclose(m_file.release());
+	}
+
+	auto EventRecorder::create(const CreateInfos& createInfos) noexcept -> std::expected<EventRecorder, CreateError> {
+		EventRecorder recorder {};
+		recorder.m_file = photon::utils::Owned{std::fopen(std::string{createInfos.path}.c_str(), "wb")};
+		if (recorder.m_file == nullptr)
+			return std::unexpected(CreateError::eFileOpening);
+		// records are small, let stdio batch them into large writes
+		std::setvbuf(recorder.m_file.get(), nullptr, _IOFBF, 1uz << 16uz);
+		if (std::fwrite(LOG_MAGIC.data(), 1uz, LOG_MAGIC.size(), recorder.m_file.get()) != LOG_MAGIC.size())
+			return std::unexpected(CreateError::eHeaderWriting);
+		recorder.m_mutex = std::make_unique<std::mutex> ();
+		recorder.m_last = std::chrono::steady_clock::now();
+		return recorder;
+	}
+
+	auto EventRecorder::record(std::int64_t key, std::uint64_t uuid, std::span<const std::byte> payload) noexcept -> void {
+		std::array<std::byte, MAX_VARINT_SIZE * 4uz> header {};
+		std::size_t size {0uz};
+		size += writeVarint((static_cast<std::uint64_t> (key) << 1u) ^ static_cast<std::uint64_t> (key >> 63), header.data() + size);
+		size += writeVarint(uuid, header.data() + size);
+		std::scoped_lock<std::mutex> _ {*m_mutex};
+		// timestamped under the lock so that the deltas never go negative
+		const auto now {std::chrono::steady_clock::now()};
+		const auto delta {std::chrono::duration_cast<std::chrono::nanoseconds> (now - std::exchange(m_last, now))};
+		size += writeVarint(static_cast<std::uint64_t> (delta.count()), header.data() + size);
+		size += writeVarint(payload.size(), header.data() + size);
+		std::fwrite(header.data(), 1uz, size, m_file.get());
+		std::fwrite(payload.data(), 1uz, payload.size(), m_file.get());
+	}
+
+	auto EventRecorder::restartClock() noexcept -> void {
+		std::scoped_lock<std::mutex> _ {*m_mutex};
+		m_last = std::chrono::steady_clock::now();
+	}
+
+	auto EventRecorder::flush() noexcept -> void {
+		std::scoped_lock<std::mutex> _ {*m_mutex};
+		std::fflush(m_file.get());
+	}
+
+
+	EventLogReader::~EventLogReader() noexcept {
+		if (m_file != nullptr)
+			std::fclose(m_file.release());
+	}
+
+	auto EventLogReader::create(const CreateInfos& createInfos) noexcept -> std::expected<EventLogReader, CreateError> {
+		EventLogReader reader {};
+		reader.m_file = photon::utils::Owned{std::fopen(std::string{createInfos.path}.c_str(), "rb")};
+		if (reader.m_file == nullptr)
+			return std::unexpected(CreateError::eFileOpening);
+		std::array<char, LOG_MAGIC.size()> magic {};
+		if (std::fread(magic.data(), 1uz, magic.size(), reader.m_file.get()) != magic.size() || magic != LOG_MAGIC)
+			return std::unexpected(CreateError::eBadHeader);
+		reader.m_timestamp = std::chrono::nanoseconds{0};
+		return reader;
+	}
+
+	auto EventLogReader::next() noexcept -> std::optional<RecordedEvent> {
+		const auto key {readVarint(m_file.get())};
+		const auto uuid {readVarint(m_file.get())};
+		const auto delta {readVarint(m_file.get())};
+		const auto size {readVarint(m_file.get())};
+		if (!key || !uuid || !delta || !size)
+			return std::nullopt;
+		RecordedEvent event {
+			.key = static_cast<std::int64_t> ((*key >> 1u) ^ (~(*key & 1u) + 1u)),
+			.uuid = *uuid,
+			.timestamp = m_timestamp + std::chrono::nanoseconds{static_cast<std::int64_t> (*delta)},
+			.payload = {}
+		};
+		event.payload.resize(*size);
+		if (std::fread(event.payload.data(), 1uz, event.payload.size(), m_file.get()) != event.payload.size())
+			return std::nullopt;
+		m_timestamp = event.timestamp;
+		return event;
+	}
+}
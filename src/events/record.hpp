@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "utils/semantic.hpp"
+
+
+namespace photon::events {
+	// how the payload of an event is written to and read back from an event log. Specialize it for
+	// the values of the queues that record
+	template <typename T>
+	struct Serializer;
+
+	template <typename T>
+	requires std::is_trivially_copyable_v<T>
+	struct Serializer<T> {
+		static auto write(const T& value, std::vector<std::byte>& buffer) noexcept -> void {
+			const auto offset {buffer.size()};
+			buffer.resize(offset + sizeof(T));
+			std::memcpy(buffer.data() + offset, &value, sizeof(T));
+		}
+		static auto read(std::span<const std::byte> bytes) noexcept -> std::optional<T> {
+			if (bytes.size() != sizeof(T))
+				return std::nullopt;
+			T value;
+			std::memcpy(&value, bytes.data(), sizeof(T));
+			return value;
+		}
+	};
+
+	template <>
+	struct Serializer<std::string> {
+		static auto write(const std::string& value, std::vector<std::byte>& buffer) noexcept -> void {
+			const auto bytes {std::as_bytes(std::span{value})};
+			buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+		}
+		static auto read(std::span<const std::byte> bytes) noexcept -> std::optional<std::string> {
+			return std::string{reinterpret_cast<const char*> (bytes.data()), bytes.size()};
+		}
+	};
+
+	template <typename T>
+	concept serializable = requires(const T& value, std::vector<std::byte>& buffer, std::span<const std::byte> bytes) {
+		{Serializer<T>::write(value, buffer)} -> std::same_as<void>;
+		{Serializer<T>::read(bytes)} -> std::same_as<std::optional<T>>;
+	};
+
+
+	struct RecordedEvent {
+		// underlying value of the key, so that logs survive reordering the events of a queue
+		std::int64_t key;
+		std::uint64_t uuid;
+		// since the start of the recording
+		std::chrono::nanoseconds timestamp;
+		std::vector<std::byte> payload;
+	};
+
+	// append-only binary log shared by any number of producers. After a small magic header, each
+	// record is its key (zigzag), uuid, nanoseconds since the previous record and payload size as
+	// LEB128 varints, followed by the payload itself
+	class EventRecorder final {
+		public:
+			enum class CreateError {
+				eFileOpening,
+				eHeaderWriting,
+			};
+			struct CreateInfos {
+				std::string_view path;
+			};
+
+			EventRecorder(const EventRecorder&) = delete;
+			auto operator=(const EventRecorder&) -> EventRecorder& = delete;
+			EventRecorder(EventRecorder&&) noexcept = default;
+			auto operator=(EventRecorder&&) noexcept -> EventRecorder& = default;
+
+			~EventRecorder() noexcept;
+
+			static auto create(const CreateInfos& createInfos) noexcept -> std::expected<EventRecorder, CreateError>;
+
+			auto record(std::int64_t key, std::uint64_t uuid, std::span<const std::byte> payload) noexcept -> void;
+			// the next record is timestamped from now instead of from the previous one
+			auto restartClock() noexcept -> void;
+			auto flush() noexcept -> void;
+
+		private:
+			EventRecorder() noexcept = default;
+
+			photon::utils::Owned<std::FILE*> m_file;
+			std::unique_ptr<std::mutex> m_mutex;
+			std::chrono::steady_clock::time_point m_last;
+	};
+
+	class EventLogReader final {
+		public:
+			enum class CreateError {
+				eFileOpening,
+				eBadHeader,
+			};
+			struct CreateInfos {
+				std::string_view path;
+			};
+
+			EventLogReader(const EventLogReader&) = delete;
+			auto operator=(const EventLogReader&) -> EventLogReader& = delete;
+			EventLogReader(EventLogReader&&) noexcept = default;
+			auto operator=(EventLogReader&&) noexcept -> EventLogReader& = default;
+
+			~EventLogReader() noexcept;
+
+			static auto create(const CreateInfos& createInfos) noexcept -> std::expected<EventLogReader, CreateError>;
+
+			// `std::nullopt` once the log is exhausted, a truncated last record included
+			auto next() noexcept -> std::optional<RecordedEvent>;
+
+		private:
+			EventLogReader() noexcept = default;
+
+			photon::utils::Owned<std::FILE*> m_file;
+			std::chrono::nanoseconds m_timestamp;
+	};
+}
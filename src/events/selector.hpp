@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <utility>
+
+#include "events/signal.hpp"
+
+
+namespace photon::events {
+	// wakeup shared by several event queues, so that a single thread can block until any of them
+	// has work. Queues are attached at construction and notify it on top of their own signal
+	class Selector final {
+		public:
+			constexpr Selector() noexcept = default;
+			~Selector() noexcept = default;
+			Selector(const Selector&) = delete;
+			auto operator=(const Selector&) -> Selector& = delete;
+			Selector(Selector&&) = delete;
+			auto operator=(Selector&&) -> Selector& = delete;
+
+			inline auto notify() noexcept -> void {
+				m_signal.notify();
+			}
+
+			template <std::predicate Predicate>
+			auto wait(Predicate&& ready) noexcept -> void {
+				m_signal.wait(std::forward<Predicate> (ready));
+			}
+
+		private:
+			Signal m_signal {};
+	};
+
+	template <typename Queue, typename Visitor>
+	struct SelectArm {
+		Queue& queue;
+		Visitor& visitor;
+	};
+
+	template <typename Queue, typename Visitor>
+	requires requires(Queue& queue, Visitor& visitor) {
+		{queue.drain(visitor)} -> std::same_as<std::size_t>;
+		{queue.getSelector()} -> std::same_as<Selector*>;
+	}
+	constexpr auto when(Queue& queue, Visitor& visitor) noexcept -> SelectArm<Queue, Visitor> {
+		return SelectArm<Queue, Visitor> {.queue = queue, .visitor = visitor};
+	}
+
+	// block until any of the queues has work, then drain each of them once with its own visitor so
+	// that a busy queue can't starve the others. Every queue must be attached to `selector`
+	template <typename... Queues, typename... Visitors>
+	auto select(Selector& selector, SelectArm<Queues, Visitors>... arms) noexcept -> std::size_t {
+		assert(((arms.queue.getSelector() == &selector) && ...) && "Queue not attached to the selector");
+		std::size_t count {0uz};
+		selector.wait([&count, &arms...] noexcept {
+			count = (arms.queue.drain(arms.visitor) + ...);
+			return count != 0uz;
+		});
+		return count;
+	}
+}
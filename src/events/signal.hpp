@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+
+
+namespace photon::events {
+	// futex-backed wakeup shared by every event queue backend. Producers bump the epoch after
+	// publishing and the consumer samples it before checking for work, so no wakeup can be lost
+	// between the check and the park
+	class Signal final {
+		public:
+			constexpr Signal() noexcept = default;
+			~Signal() noexcept = default;
+			Signal(const Signal&) = delete;
+			auto operator=(const Signal&) -> Signal& = delete;
+			Signal(Signal&&) = delete;
+			auto operator=(Signal&&) -> Signal& = delete;
+
+			inline auto notify() noexcept -> void {
+				m_epoch.fetch_add(1u, std::memory_order::release);
+				m_epoch.notify_one();
+			}
+
+			inline auto notifyAll() noexcept -> void {
+				m_epoch.fetch_add(1u, std::memory_order::release);
+				m_epoch.notify_all();
+			}
+
+			template <std::predicate Predicate>
+			auto wait(Predicate&& ready) noexcept -> void {
+				while (true) {
+					const std::uint32_t epoch {m_epoch.load(std::memory_order::acquire)};
+					if (ready())
+						return;
+					m_epoch.wait(epoch, std::memory_order::acquire);
+				}
+			}
+
+		private:
+			std::atomic<std::uint32_t> m_epoch {0u};
+	};
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace photon::internals::events {
+	// tagged storage able to hold any of `Types...` without touching the heap. Alternatives bigger
+	// than `inlineSize` (or that could throw while being moved) are kept out-of-line instead, so
+	// one oversized payload doesn't inflate every slot of the queue
+	template <std::size_t inlineSize, typename... Types>
+	requires (sizeof...(Types) > 0uz)
+	class EventSlot final {
+		template <std::size_t I>
+		using type_at = std::tuple_element_t<I, std::tuple<Types...>>;
+
+		template <typename T>
+		static constexpr bool IS_INLINE {sizeof(T) <= inlineSize && std::is_nothrow_move_constructible_v<T>};
+		static constexpr std::size_t STORAGE_SIZE {std::max({(IS_INLINE<Types> ? sizeof(Types) : sizeof(void*))...})};
+		static constexpr std::size_t STORAGE_ALIGNMENT {
+			std::max({(IS_INLINE<Types> ? alignof(Types) : alignof(void*))...})
+		};
+		static constexpr std::uint32_t EMPTY_INDEX {~0u};
+
+		public:
+			constexpr EventSlot() noexcept = default;
+			~EventSlot() noexcept {
+				this->reset();
+			}
+			EventSlot(const EventSlot&) = delete;
+			auto operator=(const EventSlot&) -> EventSlot& = delete;
+
+			EventSlot(EventSlot&& other) noexcept {
+				this->stealFrom(other);
+			}
+			auto operator=(EventSlot&& other) noexcept -> EventSlot& {
+				if (this == &other)
+					return *this;
+				this->reset();
+				this->stealFrom(other);
+				return *this;
+			}
+
+			template <std::size_t I>
+			static auto make(auto&&... args) noexcept -> EventSlot {
+				EventSlot slot {};
+				slot.template emplace<I> (std::forward<decltype(args)> (args)...);
+				return slot;
+			}
+
+			// replace the held alternative in place
+			template <std::size_t I>
+			auto emplace(auto&&... args) noexcept -> void {
+				using T = type_at<I>;
+				this->reset();
+				if constexpr (IS_INLINE<T>)
+					new (m_storage) T(std::forward<decltype(args)> (args)...);
+				else
+					new (m_storage) T*(new T(std::forward<decltype(args)> (args)...));
+				m_index = static_cast<std::uint32_t> (I);
+			}
+
+			constexpr auto empty() const noexcept -> bool {
+				return m_index == EMPTY_INDEX;
+			}
+			constexpr auto index() const noexcept -> std::size_t {
+				return m_index;
+			}
+
+			template <std::size_t I>
+			auto get() noexcept -> type_at<I>& {
+				using T = type_at<I>;
+				assert(m_index == I);
+				if constexpr (IS_INLINE<T>)
+					return *std::launder(reinterpret_cast<T*> (m_storage));
+				else
+					return **std::launder(reinterpret_cast<T**> (m_storage));
+			}
+			template <std::size_t I>
+			auto get() const noexcept -> const type_at<I>& {
+				using T = type_at<I>;
+				assert(m_index == I);
+				if constexpr (IS_INLINE<T>)
+					return *std::launder(reinterpret_cast<const T*> (m_storage));
+				else
+					return **std::launder(reinterpret_cast<T* const*> (m_storage));
+			}
+
+			// call `callback` with a reference to the held alternative
+			template <typename Callback>
+			auto visit(Callback&& callback) noexcept -> void {
+				assert(!this->empty());
+				withIndex(m_index, [this, &callback] <std::size_t I> () noexcept {
+					std::invoke(std::forward<Callback> (callback), this->get<I> ());
+				});
+			}
+			template <typename Callback>
+			auto visit(Callback&& callback) const noexcept -> void {
+				assert(!this->empty());
+				withIndex(m_index, [this, &callback] <std::size_t I> () noexcept {
+					std::invoke(std::forward<Callback> (callback), this->get<I> ());
+				});
+			}
+
+			auto reset() noexcept -> void {
+				if (this->empty())
+					return;
+				withIndex(m_index, [this] <std::size_t I> () noexcept {
+					using T = type_at<I>;
+					if constexpr (IS_INLINE<T>)
+						std::launder(reinterpret_cast<T*> (m_storage))->~T();
+					else
+						delete *std::launder(reinterpret_cast<T**> (m_storage));
+				});
+				m_index = EMPTY_INDEX;
+			}
+
+		private:
+			// one indirect call through a table generated per callback type, whatever the number
+			// of alternatives
+			template <typename Callback>
+			static auto withIndex(std::size_t index, Callback&& callback) noexcept -> void {
+				using Thunk = void(*)(Callback&) noexcept;
+				static constexpr auto table {[] <std::size_t... I> (std::index_sequence<I...>) noexcept {
+					return std::array<Thunk, sizeof...(Types)> {+[] (Callback& callback) noexcept -> void {
+						callback.template operator() <I> ();
+					}...};
+				} (std::index_sequence_for<Types...> {})};
+				assert(index < table.size());
+				table[index](callback);
+			}
+
+			auto stealFrom(EventSlot& other) noexcept -> void {
+				if (other.empty())
+					return;
+				withIndex(other.m_index, [this, &other] <std::size_t I> () noexcept {
+					using T = type_at<I>;
+					if constexpr (IS_INLINE<T>) {
+						T* element {std::launder(reinterpret_cast<T*> (other.m_storage))};
+						new (m_storage) T(std::move(*element));
+						element->~T();
+					}
+					else
+						new (m_storage) T*(*std::launder(reinterpret_cast<T**> (other.m_storage)));
+				});
+				m_index = std::exchange(other.m_index, EMPTY_INDEX);
+			}
+
+			std::uint32_t m_index {EMPTY_INDEX};
+			alignas(STORAGE_ALIGNMENT) std::byte m_storage[STORAGE_SIZE];
+	};
+}
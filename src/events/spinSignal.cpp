@@ -0,0 +1,19 @@
+#include "events/spinSignal.hpp"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+namespace photon::internals::events {
+	static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "Futexes operate on plain 32 bits words");
+
+	auto futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected) noexcept -> void {
+		// EAGAIN when the word already changed and EINTR are both handled by the caller re-checking
+		syscall(SYS_futex, reinterpret_cast<std::uint32_t*> (&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+	}
+
+	auto futexWake(std::atomic<std::uint32_t>& word) noexcept -> void {
+		syscall(SYS_futex, reinterpret_cast<std::uint32_t*> (&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+
+
+namespace photon::internals::events {
+	// raw futex calls, so that producers can skip the wake syscall entirely when nobody parked
+	auto futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected) noexcept -> void;
+	auto futexWake(std::atomic<std::uint32_t>& word) noexcept -> void;
+
+	inline auto cpuRelax() noexcept -> void {
+		#if defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+		#elif defined(__aarch64__)
+			asm volatile("yield");
+		#endif
+	}
+}
+
+
+namespace photon::events {
+	// same contract as `photon::events::Signal`, but the consumer polls for `spinCount` rounds
+	// before parking, and producers only issue the wake syscall when it actually parked. The low bit
+	// of the state is the parked flag, the rest is the epoch bumped on every notify
+	template <std::uint32_t spinCount>
+	class SpinThenParkSignal final {
+		public:
+			constexpr SpinThenParkSignal() noexcept = default;
+			~SpinThenParkSignal() noexcept = default;
+			SpinThenParkSignal(const SpinThenParkSignal&) = delete;
+			auto operator=(const SpinThenParkSignal&) -> SpinThenParkSignal& = delete;
+			SpinThenParkSignal(SpinThenParkSignal&&) = delete;
+			auto operator=(SpinThenParkSignal&&) -> SpinThenParkSignal& = delete;
+
+			auto notify() noexcept -> void {
+				std::uint32_t state {m_state.load(std::memory_order::relaxed)};
+				while (!m_state.compare_exchange_weak(state, (state + EPOCH_STEP) & ~PARKED, std::memory_order::acq_rel));
+				// only the producer that cleared the flag wakes the consumer up
+				if ((state & PARKED) == 0u)
+					return;
+				m_syscalls.fetch_add(1u, std::memory_order::relaxed);
+				internals::events::futexWake(m_state);
+			}
+
+			template <std::predicate Predicate>
+			auto wait(Predicate&& ready) noexcept -> void {
+				for (std::uint32_t i {0u}; i < spinCount; ++i) {
+					if (ready())
+						return;
+					internals::events::cpuRelax();
+				}
+				while (true) {
+					std::uint32_t state {m_state.load(std::memory_order::acquire)};
+					if (ready())
+						return;
+					// fails if a producer notified since `state` was sampled, its work must be picked up first
+					if (!m_state.compare_exchange_strong(state, state | PARKED, std::memory_order::acq_rel))
+						continue;
+					m_syscalls.fetch_add(1u, std::memory_order::relaxed);
+					internals::events::futexWait(m_state, state | PARKED);
+					m_state.fetch_and(~PARKED, std::memory_order::relaxed);
+				}
+			}
+
+			// number of futex syscalls issued so far, by both sides
+			auto getSyscallCount() const noexcept -> std::uint64_t {
+				return m_syscalls.load(std::memory_order::relaxed);
+			}
+
+		private:
+			static constexpr std::uint32_t PARKED {1u};
+			static constexpr std::uint32_t EPOCH_STEP {2u};
+
+			std::atomic<std::uint32_t> m_state {0u};
+			std::atomic<std::uint64_t> m_syscalls {0u};
+	};
+}
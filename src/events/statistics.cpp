@@ -0,0 +1,49 @@
+#include "events/statistics.hpp"
+
+#include <numeric>
+#include <print>
+
+
+namespace photon::events {
+	auto KeyStatistics::getLatencyPercentile(double ratio) const noexcept -> std::chrono::microseconds {
+		const std::uint64_t total {std::accumulate(latencyHistogram.begin(), latencyHistogram.end(), std::uint64_t{0u})};
+		if (total == 0u)
+			return std::chrono::microseconds{0};
+		const auto threshold {static_cast<std::uint64_t> (ratio * static_cast<double> (total))};
+		std::uint64_t count {0u};
+		for (std::size_t bucket {0uz}; bucket < latencyHistogram.size(); ++bucket) {
+			count += latencyHistogram[bucket];
+			if (count > threshold || count == total)
+				return std::chrono::microseconds{std::int64_t{1} << bucket};
+		}
+		return std::chrono::microseconds{std::int64_t{1} << (latencyHistogram.size() - 1uz)};
+	}
+
+	auto dumpStatistics(const EventQueueStatistics& statistics, std::FILE* file) noexcept -> void {
+		std::println(file, "event queue '{}' (id={}) : {} handled in {:.1f}s ({:.1f}/s), depth {} (max {})",
+			statistics.name,
+			statistics.id,
+			statistics.handled,
+			statistics.uptime.count(),
+			statistics.eventsPerSecond,
+			statistics.depth,
+			statistics.maxDepth
+		);
+		if (statistics.futexCalls) {
+			std::println(file, "\t{} futex calls ({:.3f} per event)",
+				*statistics.futexCalls,
+				statistics.handled == 0u ? 0.0 : static_cast<double> (*statistics.futexCalls) / static_cast<double> (statistics.handled)
+			);
+		}
+		for (const auto& key : statistics.keys) {
+			std::println(file, "\t{} : {} pushed, {} handled, latency p50 <{}us p99 <{}us max <{}us",
+				key.name,
+				key.pushed,
+				key.handled,
+				key.getLatencyPercentile(0.5).count(),
+				key.getLatencyPercentile(0.99).count(),
+				key.getLatencyPercentile(1.0).count()
+			);
+		}
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace photon::events {
+	// bucket 0 counts events handled within a microsecond of being pushed, bucket `i` the ones
+	// handled within [2^(i-1), 2^i) microseconds
+	inline constexpr std::size_t LATENCY_BUCKET_COUNT {32uz};
+
+	struct KeyStatistics {
+		std::string name;
+		std::uint64_t pushed;
+		std::uint64_t handled;
+		std::array<std::uint64_t, LATENCY_BUCKET_COUNT> latencyHistogram;
+
+		// upper bound of the bucket holding the given percentile, `ratio` being in [0, 1]
+		auto getLatencyPercentile(double ratio) const noexcept -> std::chrono::microseconds;
+	};
+
+	struct EventQueueStatistics {
+		std::string name;
+		std::size_t id;
+		std::size_t depth;
+		std::size_t maxDepth;
+		std::uint64_t handled;
+		std::chrono::duration<double> uptime;
+		double eventsPerSecond;
+		// futex syscalls issued by both sides, only tracked by the spin-then-park wakeup
+		std::optional<std::uint64_t> futexCalls;
+		std::vector<KeyStatistics> keys;
+	};
+
+	auto dumpStatistics(const EventQueueStatistics& statistics, std::FILE* file) noexcept -> void;
+}
+
+
+namespace photon::internals::events {
+	struct KeyCounters {
+		std::atomic<std::uint64_t> pushed;
+		std::atomic<std::uint64_t> handled;
+		std::array<std::atomic<std::uint64_t>, photon::events::LATENCY_BUCKET_COUNT> latencyHistogram;
+	};
+
+	// producers and the consumer only ever do relaxed increments, readers get an approximate but
+	// lock-free snapshot
+	template <std::size_t eventCount>
+	struct QueueCounters {
+		std::chrono::steady_clock::time_point creation {std::chrono::steady_clock::now()};
+		std::atomic<std::size_t> depth;
+		std::atomic<std::size_t> maxDepth;
+		std::array<KeyCounters, eventCount> keys;
+
+		auto onPush(std::size_t index) noexcept -> void {
+			keys[index].pushed.fetch_add(1u, std::memory_order::relaxed);
+		}
+		auto onEnqueue() noexcept -> void {
+			const std::size_t current {depth.fetch_add(1uz, std::memory_order::relaxed) + 1uz};
+			std::size_t maximum {maxDepth.load(std::memory_order::relaxed)};
+			while (current > maximum && !maxDepth.compare_exchange_weak(maximum, current, std::memory_order::relaxed));
+		}
+		auto onEvict() noexcept -> void {
+			depth.fetch_sub(1uz, std::memory_order::relaxed);
+		}
+		auto onHandle(std::size_t index, std::chrono::steady_clock::duration latency) noexcept -> void {
+			depth.fetch_sub(1uz, std::memory_order::relaxed);
+			const auto microseconds {std::chrono::duration_cast<std::chrono::microseconds> (latency).count()};
+			const std::size_t bucket {microseconds <= 0
+				? 0uz
+				: std::min<std::size_t> (
+					photon::events::LATENCY_BUCKET_COUNT - 1uz,
+					static_cast<std::size_t> (std::bit_width(static_cast<std::uint64_t> (microseconds)))
+				)
+			};
+			keys[index].handled.fetch_add(1u, std::memory_order::relaxed);
+			keys[index].latencyHistogram[bucket].fetch_add(1u, std::memory_order::relaxed);
+		}
+	};
+
+	struct NoCounters {};
+}
@@ -0,0 +1,238 @@
+#include "events/timerWheel.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+
+namespace photon::events {
+	TimerWheel::TimerWheel(Clock::duration resolution) noexcept :
+		m_epoch {Clock::now()},
+		m_resolution {resolution},
+		m_mutex {},
+		m_condition {},
+		m_changed {false},
+		m_current {0u},
+		m_timers {},
+		m_freeTimers {},
+		m_slots {},
+		m_occupied {},
+		m_cascaded {},
+		m_expired {},
+		m_thread {}
+	{
+		assert(resolution > Clock::duration::zero());
+	}
+
+	TimerWheel::~TimerWheel() noexcept {
+		if (!m_thread.joinable())
+			return;
+		m_thread.request_stop();
+		m_thread.join();
+	}
+
+	auto TimerWheel::schedule(Clock::duration delay, Callback&& callback) noexcept -> TimerId {
+		std::scoped_lock<std::mutex> _ {m_mutex};
+		// round up, a timer must never fire early
+		const Tick deadline {this->tickOf(Clock::now() + delay + m_resolution - Clock::duration{1})};
+		return this->allocate(std::move(callback), deadline, 0u);
+	}
+
+	auto TimerWheel::scheduleEvery(Clock::duration period, Callback&& callback) noexcept -> TimerId {
+		std::scoped_lock<std::mutex> _ {m_mutex};
+		const Tick periodTicks {std::max<Tick> (1u, static_cast<Tick> (period / m_resolution))};
+		const Tick deadline {(this->tickOf(Clock::now()) / periodTicks + 1u) * periodTicks};
+		return this->allocate(std::move(callback), deadline, periodTicks);
+	}
+
+	auto TimerWheel::cancel(TimerId id) noexcept -> void {
+		std::scoped_lock<std::mutex> _ {m_mutex};
+		if (id.index >= m_timers.size())
+			return;
+		Timer& timer {m_timers[id.index]};
+		if (timer.generation != id.generation || !timer.active)
+			return;
+		// the slot still references the timer, it is recycled once the wheel reaches it
+		timer.active = false;
+		timer.callback = nullptr;
+	}
+
+	auto TimerWheel::tickOf(Clock::time_point time) const noexcept -> Tick {
+		return static_cast<Tick> ((time - m_epoch) / m_resolution);
+	}
+
+	auto TimerWheel::timeOf(Tick tick) const noexcept -> Clock::time_point {
+		return m_epoch + m_resolution * tick;
+	}
+
+	auto TimerWheel::allocate(Callback&& callback, Tick deadline, Tick period) noexcept -> TimerId {
+		std::size_t index {m_timers.size()};
+		if (m_freeTimers.empty())
+			m_timers.emplace_back();
+		else {
+			index = m_freeTimers.back();
+			m_freeTimers.pop_back();
+		}
+		Timer& timer {m_timers[index]};
+		timer.callback = std::move(callback);
+		timer.deadline = deadline;
+		timer.period = period;
+		timer.active = true;
+		this->insert(index);
+
+		m_changed = true;
+		if (!m_thread.joinable())
+			m_thread = std::jthread{[this] (std::stop_token stopToken) noexcept {this->run(stopToken);}};
+		else
+			m_condition.notify_one();
+		return TimerId{.index = index, .generation = timer.generation};
+	}
+
+	auto TimerWheel::insert(std::size_t index) noexcept -> void {
+		Timer& timer {m_timers[index]};
+		// the current tick was already processed
+		const Tick deadline {std::max(timer.deadline, m_current + 1u)};
+		const Tick delta {deadline - m_current};
+		std::size_t level {0uz};
+		while (level + 1uz < LEVEL_COUNT && delta >= (Tick{1u} << (SLOT_BITS * (level + 1uz))))
+			++level;
+		// deadlines beyond the last level are parked in its farthest slot and cascaded again later
+		const Tick clamped {level + 1uz == LEVEL_COUNT
+			? std::min(deadline, m_current + (Tick{1u} << (SLOT_BITS * LEVEL_COUNT)) - 1u)
+			: deadline
+		};
+		const std::size_t slot {static_cast<std::size_t> ((clamped >> (SLOT_BITS * level)) & (SLOT_COUNT - 1uz))};
+		m_slots[level][slot].push_back(index);
+		m_occupied[level] |= std::uint64_t{1u} << slot;
+	}
+
+	auto TimerWheel::release(std::size_t index) noexcept -> void {
+		++m_timers[index].generation;
+		m_freeTimers.push_back(index);
+	}
+
+	auto TimerWheel::nextTick() const noexcept -> std::optional<Tick> {
+		std::optional<Tick> next {};
+		for (std::size_t level {0uz}; level < LEVEL_COUNT; ++level) {
+			if (m_occupied[level] == 0u)
+				continue;
+			const std::size_t shift {SLOT_BITS * level};
+			const std::size_t current {static_cast<std::size_t> ((m_current >> shift) & (SLOT_COUNT - 1uz))};
+			const Tick lapStart {(m_current >> (shift + SLOT_BITS)) << (shift + SLOT_BITS)};
+			// slots after the current one are reached in this lap, the others in the next one
+			const std::uint64_t after {current + 1uz == SLOT_COUNT ? 0u : m_occupied[level] >> (current + 1uz) << (current + 1uz)};
+			const Tick tick {after != 0u
+				? lapStart + (Tick{static_cast<Tick> (std::countr_zero(after))} << shift)
+				: lapStart + (Tick{1u} << (shift + SLOT_BITS)) + (Tick{static_cast<Tick> (std::countr_zero(m_occupied[level]))} << shift)
+			};
+			if (!next || tick < *next)
+				next = tick;
+		}
+		return next;
+	}
+
+	auto TimerWheel::advance(Tick target) noexcept -> void {
+		while (true) {
+			const auto tick {this->nextTick()};
+			if (!tick || *tick > target)
+				break;
+			m_current = *tick;
+			this->process(m_current);
+		}
+		m_current = std::max(m_current, target);
+	}
+
+	auto TimerWheel::process(Tick tick) noexcept -> void {
+		// cascade from the highest level whose slot starts at this tick, so that timers coming from
+		// upper levels are redistributed down before lower slots are walked
+		std::size_t topLevel {0uz};
+		while (topLevel + 1uz < LEVEL_COUNT && (tick & ((Tick{1u} << (SLOT_BITS * (topLevel + 1uz))) - 1u)) == 0u)
+			++topLevel;
+		for (std::size_t level {topLevel}; level > 0uz; --level) {
+			const std::size_t slot {static_cast<std::size_t> ((tick >> (SLOT_BITS * level)) & (SLOT_COUNT - 1uz))};
+			m_cascaded.clear();
+			std::swap(m_cascaded, m_slots[level][slot]);
+			m_occupied[level] &= ~(std::uint64_t{1u} << slot);
+			for (const std::size_t index : m_cascaded) {
+				if (m_timers[index].active)
+					this->insert(index);
+				else
+					this->release(index);
+			}
+		}
+
+		const std::size_t slot {static_cast<std::size_t> (tick & (SLOT_COUNT - 1uz))};
+		m_cascaded.clear();
+		std::swap(m_cascaded, m_slots[0][slot]);
+		m_occupied[0] &= ~(std::uint64_t{1u} << slot);
+		for (const std::size_t index : m_cascaded) {
+			Timer& timer {m_timers[index]};
+			if (!timer.active) {
+				this->release(index);
+				continue;
+			}
+			if (timer.deadline > tick) {
+				this->insert(index);
+				continue;
+			}
+			if (timer.period == 0u) {
+				m_expired.push_back(ExpiredTimer{
+					.index = index,
+					.generation = timer.generation,
+					.callback = std::move(timer.callback),
+					.periodic = false
+				});
+				timer.active = false;
+				timer.callback = nullptr;
+				this->release(index);
+				continue;
+			}
+			// an empty callback is already waiting to be called for an earlier tick of this round
+			if (timer.callback) {
+				m_expired.push_back(ExpiredTimer{
+					.index = index,
+					.generation = timer.generation,
+					.callback = std::move(timer.callback),
+					.periodic = true
+				});
+			}
+			while (timer.deadline <= tick)
+				timer.deadline += timer.period;
+			this->insert(index);
+		}
+	}
+
+	auto TimerWheel::run(std::stop_token stopToken) noexcept -> void {
+		std::unique_lock<std::mutex> lock {m_mutex};
+		while (!stopToken.stop_requested()) {
+			const auto next {this->nextTick()};
+			const auto changed {[this] noexcept {return m_changed;}};
+			if (!next)
+				m_condition.wait(lock, stopToken, changed);
+			else
+				m_condition.wait_until(lock, stopToken, this->timeOf(*next), changed);
+			m_changed = false;
+			this->advance(this->tickOf(Clock::now()));
+			if (m_expired.empty())
+				continue;
+
+			// unlocked, a callback blocked on a full queue must not keep handlers from using the wheel
+			lock.unlock();
+			for (auto& expired : m_expired)
+				expired.callback();
+			lock.lock();
+			for (auto& expired : m_expired) {
+				if (!expired.periodic)
+					continue;
+				Timer& timer {m_timers[expired.index]};
+				if (timer.active && timer.generation == expired.generation)
+					timer.callback = std::move(expired.callback);
+			}
+			// the callbacks of one-shot and cancelled timers are destroyed outside of the lock too
+			lock.unlock();
+			m_expired.clear();
+			lock.lock();
+		}
+	}
+}
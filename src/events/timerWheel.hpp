@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+
+namespace photon::events {
+	struct TimerId {
+		std::size_t index;
+		std::size_t generation;
+	};
+
+	// hierarchical timer wheel driven by a single lazily started thread. The thread sleeps until
+	// the next tick holding a timer (or a cascade of one), so idle timers cost no wakeup.
+	// Callbacks run on the timer thread once the wheel is unlocked, so they may block, schedule or
+	// cancel timers. Cancelling a timer whose callback is already running doesn't wait for it
+	class TimerWheel final {
+		public:
+			using Clock = std::chrono::steady_clock;
+			using Callback = std::move_only_function<void() noexcept>;
+
+			TimerWheel(Clock::duration resolution = std::chrono::milliseconds{1}) noexcept;
+			~TimerWheel() noexcept;
+			TimerWheel(const TimerWheel&) = delete;
+			auto operator=(const TimerWheel&) -> TimerWheel& = delete;
+			TimerWheel(TimerWheel&&) = delete;
+			auto operator=(TimerWheel&&) -> TimerWheel& = delete;
+
+			auto schedule(Clock::duration delay, Callback&& callback) noexcept -> TimerId;
+			// the first expiry is aligned on a multiple of `period` since the creation of the wheel,
+			// so every timer sharing a period fires on the same wakeup
+			auto scheduleEvery(Clock::duration period, Callback&& callback) noexcept -> TimerId;
+			auto cancel(TimerId id) noexcept -> void;
+
+		private:
+			using Tick = std::uint64_t;
+			static constexpr std::size_t LEVEL_COUNT {4uz};
+			static constexpr std::size_t SLOT_BITS {6uz};
+			static constexpr std::size_t SLOT_COUNT {1uz << SLOT_BITS};
+
+			struct Timer {
+				Callback callback;
+				Tick deadline;
+				// 0 for one-shot timers
+				Tick period;
+				std::size_t generation;
+				bool active;
+			};
+			// collected under the lock by `process`, called once it is released
+			struct ExpiredTimer {
+				std::size_t index;
+				std::size_t generation;
+				Callback callback;
+				// handed back to the timer afterwards, unless it was cancelled meanwhile
+				bool periodic;
+			};
+
+			auto tickOf(Clock::time_point time) const noexcept -> Tick;
+			auto timeOf(Tick tick) const noexcept -> Clock::time_point;
+			auto allocate(Callback&& callback, Tick deadline, Tick period) noexcept -> TimerId;
+			// `m_current` must be up to date, as deadlines are filed relative to it
+			auto insert(std::size_t index) noexcept -> void;
+			auto release(std::size_t index) noexcept -> void;
+			auto nextTick() const noexcept -> std::optional<Tick>;
+			auto advance(Tick target) noexcept -> void;
+			auto process(Tick tick) noexcept -> void;
+			auto run(std::stop_token stopToken) noexcept -> void;
+
+			const Clock::time_point m_epoch;
+			const Clock::duration m_resolution;
+			std::mutex m_mutex;
+			std::condition_variable_any m_condition;
+			bool m_changed;
+			Tick m_current;
+			std::vector<Timer> m_timers;
+			std::vector<std::size_t> m_freeTimers;
+			std::array<std::array<std::vector<std::size_t>, SLOT_COUNT>, LEVEL_COUNT> m_slots;
+			std::array<std::uint64_t, LEVEL_COUNT> m_occupied;
+			std::vector<std::size_t> m_cascaded;
+			// only touched by the timer thread
+			std::vector<ExpiredTimer> m_expired;
+			// last so it is joined before anything it uses is destroyed
+			std::jthread m_thread;
+	};
+}
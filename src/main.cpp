@@ -1,43 +1,63 @@
+#include <csignal>
 #include <cstdlib>
 #include <print>
 #include <string>
-#include <thread>
+
+#include <sys/epoll.h>
 
 #include <flex/enums/enums.hpp>
 
 #include "wayland/instance.hpp"
 #include "wayland/window.hpp"
 #include "event.hpp"
+#include "reactor.hpp"
+#include "renderer/drawList.hpp"
+#include "renderer/renderer.hpp"
 
 
 auto main(int, char**) -> int {
+	// first, so that no thread is spawned before the signals are blocked
+	auto reactor {photon::Reactor::create()};
+	if (!reactor) {
+		std::println(stderr, "Can't create reactor : {}", flex::toString(reactor.error()).value_or("?"));
+		return EXIT_FAILURE;
+	}
+
 	enum class EventType {
 		eSayHello,
 		eSayGoodbye,
 	};
-	photon::EventQueue<EventType,
+	photon::BasicEventQueue<photon::EventQueueConfig{.wakeup = photon::EventQueueWakeup::eEventFd}, EventType,
 		photon::Event<EventType::eSayHello, std::string>,
 		photon::Event<EventType::eSayGoodbye, uint32_t>
 	> eventQueue {"eventQueue"};
 
-	std::jthread _ {[&] noexcept {
-		struct EventVisitor {
-			bool running;
-			auto handle(photon::Event<EventType::eSayHello, std::string> event) noexcept -> void {
-				std::println("Hello {}!", event.value);
-			}
-			auto handle(photon::Event<EventType::eSayGoodbye, uint32_t> event) noexcept -> void {
-				std::println("Goodbye with code {}", event.value);
-				running = false;
-			}
-		};
-		EventVisitor visitor {
-			.running = true,
-		};
-		while (visitor.running) {
-			eventQueue.waitOnEvent(visitor);
+	if (auto signals {reactor->watchSignals({SIGINT, SIGTERM}, [&] (int signal) noexcept {
+		eventQueue.push<EventType::eSayGoodbye> (static_cast<uint32_t> (signal));
+	})}; !signals) {
+		std::println(stderr, "Can't watch signals : {}", flex::toString(signals.error()).value_or("?"));
+		return EXIT_FAILURE;
+	}
+
+	struct EventVisitor {
+		photon::Reactor& reactor;
+		auto handle(photon::Event<EventType::eSayHello, std::string> event) noexcept -> void {
+			std::println("Hello {}!", event.value);
 		}
-	}};
+		auto handle(photon::Event<EventType::eSayGoodbye, uint32_t> event) noexcept -> void {
+			std::println("Goodbye with code {}", event.value);
+			reactor.stop();
+		}
+	};
+	EventVisitor visitor {
+		.reactor = *reactor,
+	};
+	if (auto events {reactor->watch(eventQueue.getFd(), EPOLLIN, [&] (uint32_t) noexcept {
+		eventQueue.tryDrain(visitor);
+	})}; !events) {
+		std::println(stderr, "Can't watch event queue : {}", flex::toString(events.error()).value_or("?"));
+		return EXIT_FAILURE;
+	}
 
 	using namespace std::string_literals;
 	eventQueue.push<EventType::eSayHello> ("Albert"s);
@@ -57,19 +77,40 @@ auto main(int, char**) -> int {
 		std::println(stderr, "Can't create wayland window : {}", flex::toString(window.error()).value_or("?"));
 		return EXIT_FAILURE;
 	}
-	bool running {true};
-	while (running) {
-		if (wl_display_dispatch_pending(instance->getDisplay()) < 0)
-			return std::println(stderr, "Can't dispatch pending wayland"), EXIT_FAILURE;
-		window->fill({.r = 0, .g = 0, .b = 0, .a = 100});
-		if (!window->present())
-			return std::println(stderr, "Can't present wayland window"), EXIT_FAILURE;
+	if (auto display {reactor->setDisplay(instance->getDisplay())}; !display) {
+		std::println(stderr, "Can't watch wayland display : {}", flex::toString(display.error()).value_or("?"));
+		return EXIT_FAILURE;
+	}
 
-		using namespace std::chrono_literals;
-		std::this_thread::sleep_for(1s);
-		running = false;
+	auto renderer {photon::renderer::Renderer::create()};
+	if (!renderer) {
+		std::println(stderr, "Can't create renderer : {}", flex::toString(renderer.error()).value_or("?"));
+		return EXIT_FAILURE;
 	}
+	photon::renderer::DrawList drawList {};
+	const auto render {[&] noexcept {
+		drawList.clear();
+		drawList.fill({.r = 0, .g = 0, .b = 0, .a = 100});
+		if (auto result {renderer->render(*window, drawList)}; !result) {
+			std::println(stderr, "Can't present wayland window : {}", flex::toString(result.error()).value_or("?"));
+			reactor->stop();
+		}
+	}};
+	window->setFrameReadyCallback(render);
+	if (auto invalidations {reactor->watch(window->getInvalidationFd(), EPOLLIN, [&] (uint32_t) noexcept {
+		window->processInvalidations();
+	})}; !invalidations) {
+		std::println(stderr, "Can't watch window invalidations : {}", flex::toString(invalidations.error()).value_or("?"));
+		return EXIT_FAILURE;
+	}
+	if (window->isFrameReady())
+		render();
 
-	eventQueue.push<EventType::eSayGoodbye> (12u);
+	if (auto result {reactor->run()}; !result) {
+		std::println(stderr, "Reactor stopped : {}", flex::toString(result.error()).value_or("?"));
+		return EXIT_FAILURE;
+	}
+	const auto& statistics {renderer->getStatistics()};
+	std::println("Frames presented : {}, skipped : {}", statistics.presented, statistics.skipped);
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,235 @@
+#include "reactor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <wayland-client-core.h>
+
+
+namespace photon {
+	// reserved epoll data of the display fd, watch ids start at 1
+	static constexpr Reactor::WatchId DISPLAY_ID {0u};
+	static constexpr std::size_t MAX_EVENTS_PER_WAIT {32uz};
+
+	Reactor::Reactor(Reactor&& other) noexcept :
+		m_epoll {std::exchange(other.m_epoll, -1)},
+		m_display {std::exchange(other.m_display, nullptr)},
+		m_displayWantsWrite {other.m_displayWantsWrite},
+		m_running {other.m_running},
+		m_nextId {other.m_nextId},
+		m_sources {std::move(other.m_sources)}
+	{
+		other.m_sources.clear();
+	}
+
+	Reactor::~Reactor() noexcept {
+		for (const auto& [_, source] : m_sources) {
+			if (source.owned)
+				close(source.fd);
+		}
+		if (m_epoll >= 0)
+			close(m_epoll);
+	}
+
+	auto Reactor::create() noexcept -> std::expected<Reactor, CreateError> {
+		Reactor reactor {};
+		reactor.m_epoll = epoll_create1(EPOLL_CLOEXEC);
+		if (reactor.m_epoll < 0)
+			return std::unexpected(CreateError::eEpollCreation);
+		return reactor;
+	}
+
+	auto Reactor::setDisplay(wl_display* display) noexcept -> std::expected<void, WatchError> {
+		epoll_event event {
+			.events = EPOLLIN,
+			.data = {.u64 = DISPLAY_ID}
+		};
+		if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, wl_display_get_fd(display), &event) != 0)
+			return std::unexpected(WatchError::eEpollRegistration);
+		m_display = display;
+		return {};
+	}
+
+	auto Reactor::watch(int fd, std::uint32_t events, Callback&& callback) noexcept -> std::expected<WatchId, WatchError> {
+		return this->add(fd, events, false, std::move(callback));
+	}
+
+	auto Reactor::addTimer(
+		std::chrono::nanoseconds delay,
+		std::chrono::nanoseconds period,
+		TimerCallback&& callback
+	) noexcept -> std::expected<WatchId, WatchError> {
+		const int fd {timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)};
+		if (fd < 0)
+			return std::unexpected(WatchError::eTimerCreation);
+		const auto toTimespec {[] (std::chrono::nanoseconds duration) noexcept -> timespec {
+			const auto seconds {std::chrono::duration_cast<std::chrono::seconds> (duration)};
+			return timespec{
+				.tv_sec = static_cast<time_t> (seconds.count()),
+				.tv_nsec = static_cast<long> ((duration - seconds).count())
+			};
+		}};
+		// a zero `it_value` would disarm the timer instead of firing right away
+		const itimerspec timer {
+			.it_interval = toTimespec(period),
+			.it_value = toTimespec(std::max(delay, std::chrono::nanoseconds{1}))
+		};
+		if (timerfd_settime(fd, 0, &timer, nullptr) != 0) {
+			close(fd);
+			return std::unexpected(WatchError::eTimerCreation);
+		}
+		auto id {this->add(fd, EPOLLIN, true, [fd, callback = std::move(callback)] (std::uint32_t) mutable noexcept {
+			std::uint64_t expirations {0u};
+			if (read(fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+				callback(expirations);
+		})};
+		if (!id)
+			close(fd);
+		return id;
+	}
+
+	auto Reactor::watchSignals(std::initializer_list<int> signals, SignalCallback&& callback) noexcept
+		-> std::expected<WatchId, WatchError>
+	{
+		sigset_t mask {};
+		sigemptyset(&mask);
+		for (const int signal : signals)
+			sigaddset(&mask, signal);
+		if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0)
+			return std::unexpected(WatchError::eSignalMasking);
+		const int fd {signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC)};
+		if (fd < 0)
+			return std::unexpected(WatchError::eSignalCreation);
+		auto id {this->add(fd, EPOLLIN, true, [fd, callback = std::move(callback)] (std::uint32_t) mutable noexcept {
+			signalfd_siginfo info {};
+			while (read(fd, &info, sizeof(info)) == sizeof(info))
+				callback(static_cast<int> (info.ssi_signo));
+		})};
+		if (!id)
+			close(fd);
+		return id;
+	}
+
+	auto Reactor::unwatch(WatchId id) noexcept -> void {
+		const auto source {m_sources.find(id)};
+		if (source == m_sources.end())
+			return;
+		epoll_ctl(m_epoll, EPOLL_CTL_DEL, source->second.fd, nullptr);
+		if (source->second.owned)
+			close(source->second.fd);
+		m_sources.erase(source);
+	}
+
+	auto Reactor::run() noexcept -> std::expected<void, RunError> {
+		m_running = true;
+		while (m_running) {
+			if (auto result {this->runOnce()}; !result)
+				return result;
+		}
+		return {};
+	}
+
+	auto Reactor::runOnce(std::chrono::milliseconds timeout) noexcept -> std::expected<void, RunError> {
+		if (m_display != nullptr) {
+			if (auto result {this->prepareDisplay()}; !result)
+				return result;
+		}
+
+		std::array<epoll_event, MAX_EVENTS_PER_WAIT> events {};
+		int count {};
+		while ((count = epoll_wait(m_epoll, events.data(), events.size(), static_cast<int> (timeout.count()))) < 0) {
+			if (errno == EINTR)
+				continue;
+			if (m_display != nullptr)
+				wl_display_cancel_read(m_display);
+			return std::unexpected(RunError::eEpollWaiting);
+		}
+
+		// the display is handled first : the read must be either completed or cancelled before
+		// any callback gets a chance to touch wayland
+		bool displayReadable {false};
+		bool displayWritable {false};
+		for (int i {0}; i < count; ++i) {
+			if (events[i].data.u64 != DISPLAY_ID)
+				continue;
+			displayReadable = (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0u;
+			displayWritable = (events[i].events & EPOLLOUT) != 0u;
+		}
+		if (m_display != nullptr) {
+			if (displayReadable) {
+				if (wl_display_read_events(m_display) != 0)
+					return std::unexpected(RunError::eWaylandReading);
+			}
+			else
+				wl_display_cancel_read(m_display);
+			if (wl_display_dispatch_pending(m_display) < 0)
+				return std::unexpected(RunError::eWaylandDispatching);
+			if (displayWritable)
+				this->updateDisplayInterest(false);
+		}
+
+		for (int i {0}; i < count; ++i) {
+			if (events[i].data.u64 == DISPLAY_ID)
+				continue;
+			// the source may have been removed by an earlier callback of this round
+			const WatchId id {events[i].data.u64};
+			auto source {m_sources.find(id)};
+			if (source == m_sources.end())
+				continue;
+			// moved out for the call, as the callback may unwatch its own source or add new ones
+			Callback callback {std::move(source->second.callback)};
+			callback(events[i].events);
+			if (source = m_sources.find(id); source != m_sources.end())
+				source->second.callback = std::move(callback);
+		}
+		return {};
+	}
+
+	auto Reactor::add(int fd, std::uint32_t events, bool owned, Callback&& callback) noexcept -> std::expected<WatchId, WatchError> {
+		const WatchId id {m_nextId++};
+		epoll_event event {
+			.events = events,
+			.data = {.u64 = id}
+		};
+		if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+			return std::unexpected(WatchError::eEpollRegistration);
+		m_sources.emplace(id, Source{.fd = fd, .owned = owned, .callback = std::move(callback)});
+		return id;
+	}
+
+	auto Reactor::prepareDisplay() noexcept -> std::expected<void, RunError> {
+		while (wl_display_prepare_read(m_display) != 0) {
+			if (wl_display_dispatch_pending(m_display) < 0)
+				return std::unexpected(RunError::eWaylandDispatching);
+		}
+		// a full socket buffer isn't an error, the rest of the requests are sent once it drains
+		if (wl_display_flush(m_display) < 0) {
+			if (errno != EAGAIN) {
+				wl_display_cancel_read(m_display);
+				return std::unexpected(RunError::eWaylandFlushing);
+			}
+			this->updateDisplayInterest(true);
+		}
+		return {};
+	}
+
+	auto Reactor::updateDisplayInterest(bool wantsWrite) noexcept -> void {
+		if (m_displayWantsWrite == wantsWrite)
+			return;
+		m_displayWantsWrite = wantsWrite;
+		epoll_event event {
+			.events = EPOLLIN | (wantsWrite ? EPOLLOUT : 0u),
+			.data = {.u64 = DISPLAY_ID}
+		};
+		epoll_ctl(m_epoll, EPOLL_CTL_MOD, wl_display_get_fd(m_display), &event);
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <initializer_list>
+#include <unordered_map>
+
+#include <wayland-client-core.h>
+
+
+namespace photon {
+	// single-threaded epoll loop owning every fd the bar waits on : the wayland display, timers,
+	// signals and the fds of the modules. It only wakes up when one of them is ready, and callbacks
+	// run on the thread calling `run`
+	class Reactor final {
+		public:
+			enum class CreateError {
+				eEpollCreation,
+			};
+			enum class WatchError {
+				eEpollRegistration,
+				eTimerCreation,
+				eSignalMasking,
+				eSignalCreation,
+			};
+			enum class RunError {
+				eEpollWaiting,
+				eWaylandFlushing,
+				eWaylandReading,
+				eWaylandDispatching,
+			};
+
+			// called with the epoll events the fd is ready for
+			using Callback = std::move_only_function<void(std::uint32_t) noexcept>;
+			// called with the number of expirations since the last call
+			using TimerCallback = std::move_only_function<void(std::uint64_t) noexcept>;
+			using SignalCallback = std::move_only_function<void(int) noexcept>;
+			using WatchId = std::uint64_t;
+
+			Reactor(const Reactor&) = delete;
+			auto operator=(const Reactor&) -> Reactor& = delete;
+			auto operator=(Reactor&&) -> Reactor& = delete;
+
+			Reactor(Reactor&& other) noexcept;
+			~Reactor() noexcept;
+
+			[[nodiscard]]
+			static auto create() noexcept -> std::expected<Reactor, CreateError>;
+
+			// the display is flushed before every wait and its events dispatched as soon as they
+			// arrive, following the `wl_display_prepare_read` protocol
+			auto setDisplay(wl_display* display) noexcept -> std::expected<void, WatchError>;
+
+			// `events` is an `EPOLLIN`/`EPOLLOUT`/... mask, the fd stays owned by the caller
+			auto watch(int fd, std::uint32_t events, Callback&& callback) noexcept -> std::expected<WatchId, WatchError>;
+			// a zero `period` makes a one-shot timer
+			auto addTimer(
+				std::chrono::nanoseconds delay,
+				std::chrono::nanoseconds period,
+				TimerCallback&& callback
+			) noexcept -> std::expected<WatchId, WatchError>;
+			// block `signals` for the calling thread and deliver them through a signalfd instead. Must
+			// be called before any other thread is spawned, which would otherwise inherit an
+			// unblocked mask and receive them
+			auto watchSignals(std::initializer_list<int> signals, SignalCallback&& callback) noexcept
+				-> std::expected<WatchId, WatchError>;
+			// also closes the fds the reactor created for timers and signals. Safe from a callback
+			auto unwatch(WatchId id) noexcept -> void;
+
+			// dispatch until `stop` is called from a callback
+			auto run() noexcept -> std::expected<void, RunError>;
+			// wait at most `timeout` (forever if negative) for fds to be ready, then dispatch them
+			auto runOnce(std::chrono::milliseconds timeout = std::chrono::milliseconds{-1}) noexcept -> std::expected<void, RunError>;
+			inline auto stop() noexcept -> void {
+				m_running = false;
+			}
+
+		private:
+			struct Source {
+				int fd;
+				// timers and signals own their fd
+				bool owned;
+				Callback callback;
+			};
+
+			constexpr Reactor() noexcept = default;
+
+			auto add(int fd, std::uint32_t events, bool owned, Callback&& callback) noexcept -> std::expected<WatchId, WatchError>;
+			auto prepareDisplay() noexcept -> std::expected<void, RunError>;
+			auto updateDisplayInterest(bool wantsWrite) noexcept -> void;
+
+			int m_epoll {-1};
+			wl_display* m_display {nullptr};
+			// waiting for the display fd to be writable again to finish a flush
+			bool m_displayWantsWrite {false};
+			bool m_running {false};
+			WatchId m_nextId {1u};
+			std::unordered_map<WatchId, Source> m_sources {};
+	};
+}
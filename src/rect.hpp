@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+
+namespace photon {
+	struct Rect {
+		std::int32_t x;
+		std::int32_t y;
+		std::uint32_t width;
+		std::uint32_t height;
+
+		constexpr auto empty() const noexcept -> bool {
+			return width == 0u || height == 0u;
+		}
+		constexpr auto getArea() const noexcept -> std::uint64_t {
+			return static_cast<std::uint64_t> (width) * height;
+		}
+		constexpr auto intersects(const Rect& other) const noexcept -> bool {
+			return !this->empty() && !other.empty()
+				&& x < other.x + static_cast<std::int64_t> (other.width)
+				&& other.x < x + static_cast<std::int64_t> (width)
+				&& y < other.y + static_cast<std::int64_t> (other.height)
+				&& other.y < y + static_cast<std::int64_t> (height);
+		}
+		// empty if they don't overlap
+		constexpr auto intersect(const Rect& other) const noexcept -> Rect {
+			if (!this->intersects(other))
+				return Rect{};
+			const std::int64_t left {std::max(x, other.x)};
+			const std::int64_t top {std::max(y, other.y)};
+			const std::int64_t right {std::min(x + static_cast<std::int64_t> (width), other.x + static_cast<std::int64_t> (other.width))};
+			const std::int64_t bottom {std::min(y + static_cast<std::int64_t> (height), other.y + static_cast<std::int64_t> (other.height))};
+			return Rect{
+				.x = static_cast<std::int32_t> (left),
+				.y = static_cast<std::int32_t> (top),
+				.width = static_cast<std::uint32_t> (right - left),
+				.height = static_cast<std::uint32_t> (bottom - top)
+			};
+		}
+		// smallest rect containing both
+		constexpr auto unite(const Rect& other) const noexcept -> Rect {
+			if (this->empty())
+				return other;
+			if (other.empty())
+				return *this;
+			const std::int64_t left {std::min(x, other.x)};
+			const std::int64_t top {std::min(y, other.y)};
+			const std::int64_t right {std::max(x + static_cast<std::int64_t> (width), other.x + static_cast<std::int64_t> (other.width))};
+			const std::int64_t bottom {std::max(y + static_cast<std::int64_t> (height), other.y + static_cast<std::int64_t> (other.height))};
+			return Rect{
+				.x = static_cast<std::int32_t> (left),
+				.y = static_cast<std::int32_t> (top),
+				.width = static_cast<std::uint32_t> (right - left),
+				.height = static_cast<std::uint32_t> (bottom - top)
+			};
+		}
+
+		constexpr auto operator==(const Rect&) const noexcept -> bool = default;
+	};
+
+	// small set of rects, good enough to describe the damage of a frame. Overlapping rects are
+	// merged, and once `MAX_RECTS` is reached everything collapses into the bounding box
+	class Region final {
+		public:
+			static constexpr std::size_t MAX_RECTS {8uz};
+
+			constexpr Region() noexcept = default;
+			constexpr Region(const Rect& rect) noexcept {
+				this->add(rect);
+			}
+
+			constexpr auto add(Rect rect) noexcept -> void {
+				if (rect.empty())
+					return;
+				// merging may make the rect overlap others it didn't before, hence the restart
+				for (std::size_t i {0uz}; i < m_count;) {
+					if (!m_rects[i].intersects(rect)) {
+						++i;
+						continue;
+					}
+					rect = rect.unite(m_rects[i]);
+					m_rects[i] = m_rects[--m_count];
+					i = 0uz;
+				}
+				if (m_count == MAX_RECTS) {
+					rect = rect.unite(this->getBounds());
+					m_count = 0uz;
+				}
+				m_rects[m_count++] = rect;
+			}
+			constexpr auto add(const Region& region) noexcept -> void {
+				for (const auto& rect : region.getRects())
+					this->add(rect);
+			}
+			constexpr auto clear() noexcept -> void {
+				m_count = 0uz;
+			}
+
+			constexpr auto empty() const noexcept -> bool {
+				return m_count == 0uz;
+			}
+			constexpr auto getRects() const noexcept -> std::span<const Rect> {
+				return std::span{m_rects.data(), m_count};
+			}
+			constexpr auto getBounds() const noexcept -> Rect {
+				Rect bounds {};
+				for (const auto& rect : this->getRects())
+					bounds = bounds.unite(rect);
+				return bounds;
+			}
+
+		private:
+			std::array<Rect, MAX_RECTS> m_rects {};
+			std::size_t m_count {0uz};
+	};
+}
@@ -0,0 +1,110 @@
+#include "renderer/drawList.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+
+namespace photon::renderer {
+	// FNV-1a, fed field by field so that padding never leaks into the hash
+	static constexpr std::uint64_t FNV_OFFSET_BASIS {0xcbf29ce484222325u};
+	static constexpr std::uint64_t FNV_PRIME {0x100000001b3u};
+
+	static constexpr auto hashWord(std::uint64_t hash, std::uint32_t word) noexcept -> std::uint64_t {
+		for (std::uint32_t shift {0u}; shift < 32u; shift += 8u) {
+			hash ^= (word >> shift) & 0xffu;
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+
+	auto DrawList::clear() noexcept -> void {
+		m_commands.clear();
+		m_hash = 0u;
+	}
+
+	auto DrawList::fill(photon::Color color) noexcept -> void {
+		this->record(DrawCommand{
+			.type = DrawCommand::Type::eFill,
+			.sampling = DrawCommand::Sampling::eNone,
+			.radius = 0u,
+			.borderWidth = 0u,
+			.rect = {},
+			.color = color,
+			.texture = {}
+		});
+	}
+
+	auto DrawList::rect(const photon::Rect& rect, photon::Color color) noexcept -> void {
+		this->roundedRect(rect, 0u, color);
+	}
+
+	auto DrawList::roundedRect(const photon::Rect& rect, std::uint16_t radius, photon::Color color) noexcept -> void {
+		this->record(DrawCommand{
+			.type = DrawCommand::Type::eQuad,
+			.sampling = DrawCommand::Sampling::eNone,
+			.radius = radius,
+			.borderWidth = 0u,
+			.rect = rect,
+			.color = color,
+			.texture = {}
+		});
+	}
+
+	auto DrawList::border(const photon::Rect& rect, std::uint16_t width, photon::Color color, std::uint16_t radius) noexcept -> void {
+		if (width == 0u)
+			return;
+		this->record(DrawCommand{
+			.type = DrawCommand::Type::eQuad,
+			.sampling = DrawCommand::Sampling::eNone,
+			.radius = radius,
+			.borderWidth = width,
+			.rect = rect,
+			.color = color,
+			.texture = {}
+		});
+	}
+
+	auto DrawList::texturedQuad(const photon::Rect& rect, const TextureRegion& texture, photon::Color tint) noexcept -> void {
+		this->record(DrawCommand{
+			.type = DrawCommand::Type::eQuad,
+			.sampling = DrawCommand::Sampling::eColor,
+			.radius = 0u,
+			.borderWidth = 0u,
+			.rect = rect,
+			.color = tint,
+			.texture = texture
+		});
+	}
+
+	auto DrawList::distanceField(const photon::Rect& rect, const TextureRegion& texture, photon::Color color) noexcept -> void {
+		this->record(DrawCommand{
+			.type = DrawCommand::Type::eQuad,
+			.sampling = DrawCommand::Sampling::eDistanceField,
+			.radius = 0u,
+			.borderWidth = 0u,
+			.rect = rect,
+			.color = color,
+			.texture = texture
+		});
+	}
+
+	auto DrawList::record(const DrawCommand& command) noexcept -> void {
+		// an empty list always hashes to 0
+		if (m_commands.empty())
+			m_hash = FNV_OFFSET_BASIS;
+		m_hash = hashWord(m_hash, std::to_underlying(command.type) | static_cast<std::uint32_t> (std::to_underlying(command.sampling)) << 8u);
+		m_hash = hashWord(m_hash, command.radius | static_cast<std::uint32_t> (command.borderWidth) << 16u);
+		m_hash = hashWord(m_hash, std::bit_cast<std::uint32_t> (command.rect.x));
+		m_hash = hashWord(m_hash, std::bit_cast<std::uint32_t> (command.rect.y));
+		m_hash = hashWord(m_hash, command.rect.width);
+		m_hash = hashWord(m_hash, command.rect.height);
+		m_hash = hashWord(m_hash, command.color.into<photon::ARGBColor> ().into<std::uint32_t> ());
+		if (command.sampling != DrawCommand::Sampling::eNone) {
+			m_hash = hashWord(m_hash, command.texture.u0 | static_cast<std::uint32_t> (command.texture.v0) << 16u);
+			m_hash = hashWord(m_hash, command.texture.u1 | static_cast<std::uint32_t> (command.texture.v1) << 16u);
+			m_hash = hashWord(m_hash, command.texture.layer);
+		}
+		m_commands.push_back(command);
+	}
+}
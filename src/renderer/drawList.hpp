@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "color.hpp"
+#include "rect.hpp"
+
+
+namespace photon::renderer {
+	// area of a texture array, coordinates normalized to the full `std::uint16_t` range
+	struct TextureRegion {
+		std::uint16_t u0;
+		std::uint16_t v0;
+		std::uint16_t u1;
+		std::uint16_t v1;
+		std::uint16_t layer;
+	};
+
+	struct DrawCommand {
+		enum class Type : std::uint8_t {
+			eFill,
+			eQuad,
+		};
+		// how `texture` is read, if at all
+		enum class Sampling : std::uint8_t {
+			eNone,
+			eColor,
+			// single channel signed distance field, edge at 0.5
+			eDistanceField,
+		};
+
+		Type type;
+		Sampling sampling;
+		// the fields below are unused by `eFill`
+		std::uint16_t radius;
+		// 0 fills the quad
+		std::uint16_t borderWidth;
+		photon::Rect rect;
+		photon::Color color;
+		TextureRegion texture;
+	};
+
+	// commands of one frame, hashed as they are recorded so that a frame identical to the previous
+	// one can be detected without keeping nor comparing the whole list
+	class DrawList final {
+		public:
+			DrawList() noexcept = default;
+			~DrawList() noexcept = default;
+			DrawList(const DrawList&) = delete;
+			auto operator=(const DrawList&) -> DrawList& = delete;
+			DrawList(DrawList&&) noexcept = default;
+			auto operator=(DrawList&&) noexcept -> DrawList& = default;
+
+			// keeps the allocation, a list is meant to be reused for every frame
+			auto clear() noexcept -> void;
+			auto fill(photon::Color color) noexcept -> void;
+			auto rect(const photon::Rect& rect, photon::Color color) noexcept -> void;
+			auto roundedRect(const photon::Rect& rect, std::uint16_t radius, photon::Color color) noexcept -> void;
+			auto border(const photon::Rect& rect, std::uint16_t width, photon::Color color, std::uint16_t radius = 0u) noexcept -> void;
+			// the texel is multiplied by `tint`
+			auto texturedQuad(
+				const photon::Rect& rect,
+				const TextureRegion& texture,
+				photon::Color tint = {.r = 255, .g = 255, .b = 255, .a = 255}
+			) noexcept -> void;
+			// quad whose coverage comes from a distance field texture, for glyphs
+			auto distanceField(const photon::Rect& rect, const TextureRegion& texture, photon::Color color) noexcept -> void;
+
+			inline auto getCommands() const noexcept -> std::span<const DrawCommand> {
+				return m_commands;
+			}
+			inline auto getHash() const noexcept -> std::uint64_t {
+				return m_hash;
+			}
+
+		private:
+			auto record(const DrawCommand& command) noexcept -> void;
+
+			std::vector<DrawCommand> m_commands {};
+			std::uint64_t m_hash {0u};
+	};
+}
@@ -0,0 +1,271 @@
+#include "renderer/glyphAtlas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+
+#include <glad/glad.h>
+
+
+namespace photon::renderer {
+	// keeps linear filtering of a glyph from bleeding into its neighbours
+	static constexpr std::uint32_t GLYPH_PADDING {1u};
+
+	static auto toTextureCoordinate(std::uint32_t texel, std::uint32_t size) noexcept -> std::uint16_t {
+		return static_cast<std::uint16_t> (
+			static_cast<std::uint64_t> (texel) * std::numeric_limits<std::uint16_t>::max() / size
+		);
+	}
+
+	GlyphAtlas::GlyphAtlas(GlyphAtlas&& other) noexcept :
+		m_library {std::move(other.m_library)},
+		m_face {std::move(other.m_face)},
+		m_texture {std::exchange(other.m_texture, 0u)},
+		m_textureLayers {other.m_textureLayers},
+		m_pixelSize {other.m_pixelSize},
+		m_pageSize {other.m_pageSize},
+		m_maxPages {other.m_maxPages},
+		m_lineHeight {other.m_lineHeight},
+		m_frame {other.m_frame},
+		m_generation {other.m_generation},
+		m_pages {std::move(other.m_pages)},
+		m_glyphs {std::move(other.m_glyphs)}
+	{}
+
+	GlyphAtlas::~GlyphAtlas() noexcept {
+		if (m_texture != 0u)
+			glDeleteTextures(1, &m_texture);
+		if (m_face != nullptr)
+			FT_Done_Face(m_face.release());
+		if (m_library != nullptr)
+			FT_Done_FreeType(m_library.release());
+	}
+
+	auto GlyphAtlas::create(const CreateInfos& createInfos) noexcept -> std::expected<GlyphAtlas, CreateError> {
+		GlyphAtlas atlas {};
+		FT_Library library {nullptr};
+		if (FT_Init_FreeType(&library) != 0)
+			return std::unexpected(CreateError::eFreeTypeInitialization);
+		atlas.m_library = photon::utils::Owned{std::move(library)};
+		const FT_Int spread {static_cast<FT_Int> (createInfos.spread)};
+		if (FT_Property_Set(atlas.m_library.get(), "sdf", "spread", &spread) != 0)
+			return std::unexpected(CreateError::eFreeTypeInitialization);
+
+		FT_Face face {nullptr};
+		const std::string fontPath {createInfos.fontPath};
+		if (FT_New_Face(atlas.m_library.get(), fontPath.c_str(), 0, &face) != 0)
+			return std::unexpected(CreateError::eFontLoading);
+		atlas.m_face = photon::utils::Owned{std::move(face)};
+		if (FT_Set_Pixel_Sizes(atlas.m_face.get(), 0, createInfos.pixelSize) != 0)
+			return std::unexpected(CreateError::eFontSizing);
+
+		atlas.m_pixelSize = createInfos.pixelSize;
+		atlas.m_pageSize = createInfos.pageSize;
+		atlas.m_maxPages = std::max(
+			createInfos.memoryBudget / (static_cast<std::size_t> (createInfos.pageSize) * createInfos.pageSize),
+			1uz
+		);
+		atlas.m_lineHeight = static_cast<float> (atlas.m_face->size->metrics.height) / 64.f;
+		for (const char32_t codepoint : createInfos.charset.getCharacters())
+			(void)atlas.getGlyph(codepoint);
+		atlas.flush();
+		return atlas;
+	}
+
+	auto GlyphAtlas::getGlyph(char32_t codepoint) noexcept -> const Glyph* {
+		const CachedGlyph* cached {nullptr};
+		if (const auto glyph {m_glyphs.find(codepoint)}; glyph != m_glyphs.end())
+			cached = &glyph->second;
+		else
+			cached = this->insert(codepoint);
+		if (cached == nullptr || cached->residency == CachedGlyph::Residency::eMissing)
+			return nullptr;
+		if (cached->residency == CachedGlyph::Residency::ePacked)
+			m_pages[cached->glyph.texture.layer].lastUsed = m_frame;
+		return &cached->glyph;
+	}
+
+	auto GlyphAtlas::flush() noexcept -> void {
+		// immutable storage, growing means copying the pages already uploaded to a new texture
+		if (m_pages.size() > m_textureLayers) {
+			const std::size_t layers {std::min(std::max(m_textureLayers * 2uz, m_pages.size()), m_maxPages)};
+			GLuint texture {0u};
+			glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &texture);
+			glTextureStorage3D(
+				texture, 1, GL_R8,
+				static_cast<GLsizei> (m_pageSize), static_cast<GLsizei> (m_pageSize), static_cast<GLsizei> (layers)
+			);
+			glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			if (m_texture != 0u) {
+				glCopyImageSubData(
+					m_texture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+					texture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+					static_cast<GLsizei> (m_pageSize), static_cast<GLsizei> (m_pageSize), static_cast<GLsizei> (m_textureLayers)
+				);
+				glDeleteTextures(1, &m_texture);
+			}
+			m_texture = texture;
+			m_textureLayers = layers;
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint> (m_pageSize));
+		bool uploaded {false};
+		for (std::size_t i {0uz}; i < m_pages.size(); ++i) {
+			Page& page {m_pages[i]};
+			if (page.dirty.empty())
+				continue;
+			// the bounds of what changed, a single upload however many glyphs were inserted
+			glTextureSubImage3D(
+				m_texture, 0,
+				page.dirty.x, page.dirty.y, static_cast<GLint> (i),
+				static_cast<GLsizei> (page.dirty.width), static_cast<GLsizei> (page.dirty.height), 1,
+				GL_RED, GL_UNSIGNED_BYTE,
+				page.pixels.data() + static_cast<std::size_t> (page.dirty.y) * m_pageSize + static_cast<std::size_t> (page.dirty.x)
+			);
+			page.dirty = photon::Rect{};
+			uploaded = true;
+		}
+		if (uploaded)
+			++m_generation;
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		++m_frame;
+	}
+
+	auto GlyphAtlas::insert(char32_t codepoint) noexcept -> const CachedGlyph* {
+		FT_Face face {m_face.get()};
+		const auto cache {[this, codepoint] (const CachedGlyph& glyph) noexcept -> const CachedGlyph* {
+			return &m_glyphs.insert_or_assign(codepoint, glyph).first->second;
+		}};
+		static constexpr CachedGlyph MISSING {.glyph = {}, .residency = CachedGlyph::Residency::eMissing};
+		const FT_UInt index {FT_Get_Char_Index(face, codepoint)};
+		if (index == 0u || FT_Load_Glyph(face, index, FT_LOAD_DEFAULT) != 0)
+			return cache(MISSING);
+		CachedGlyph cached {
+			.glyph = Glyph{
+				.texture = {},
+				.left = 0.f,
+				.top = 0.f,
+				.width = 0.f,
+				.height = 0.f,
+				.advance = static_cast<float> (face->glyph->advance.x) / 64.f
+			},
+			.residency = CachedGlyph::Residency::eBlank
+		};
+		// blanks have no outline to render, only an advance
+		if (face->glyph->outline.n_points == 0)
+			return cache(cached);
+		if (FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF) != 0)
+			return cache(MISSING);
+
+		const FT_Bitmap& bitmap {face->glyph->bitmap};
+		if (bitmap.width + GLYPH_PADDING > m_pageSize || bitmap.rows + GLYPH_PADDING > m_pageSize)
+			return cache(MISSING);
+		// not cached, the glyph may fit once the current frame is over
+		const auto allocation {this->allocate(bitmap.width + GLYPH_PADDING, bitmap.rows + GLYPH_PADDING)};
+		if (!allocation)
+			return nullptr;
+		const auto [pageIndex, position] {*allocation};
+		Page& page {m_pages[pageIndex]};
+		for (std::uint32_t row {0u}; row < bitmap.rows; ++row) {
+			std::memcpy(
+				page.pixels.data() + static_cast<std::size_t> (position.y + row) * m_pageSize + position.x,
+				bitmap.buffer + static_cast<std::ptrdiff_t> (row) * bitmap.pitch,
+				bitmap.width
+			);
+		}
+		// the padding too, the texels of a fresh layer are undefined until uploaded once
+		page.dirty = page.dirty.unite(photon::Rect{
+			.x = static_cast<std::int32_t> (position.x),
+			.y = static_cast<std::int32_t> (position.y),
+			.width = bitmap.width + GLYPH_PADDING,
+			.height = bitmap.rows + GLYPH_PADDING
+		});
+
+		cached.residency = CachedGlyph::Residency::ePacked;
+		cached.glyph.texture = TextureRegion{
+			.u0 = toTextureCoordinate(position.x, m_pageSize),
+			.v0 = toTextureCoordinate(position.y, m_pageSize),
+			.u1 = toTextureCoordinate(position.x + bitmap.width, m_pageSize),
+			.v1 = toTextureCoordinate(position.y + bitmap.rows, m_pageSize),
+			.layer = static_cast<std::uint16_t> (pageIndex)
+		};
+		cached.glyph.left = static_cast<float> (face->glyph->bitmap_left);
+		cached.glyph.top = static_cast<float> (face->glyph->bitmap_top);
+		cached.glyph.width = static_cast<float> (bitmap.width);
+		cached.glyph.height = static_cast<float> (bitmap.rows);
+		return cache(cached);
+	}
+
+	auto GlyphAtlas::allocate(std::uint32_t width, std::uint32_t height) noexcept
+		-> std::optional<std::pair<std::size_t, PackedPosition>>
+	{
+		for (std::size_t i {0uz}; i < m_pages.size(); ++i) {
+			if (const auto position {m_pages[i].packer.insert(width, height)})
+				return std::pair{i, *position};
+		}
+
+		std::size_t index {m_pages.size()};
+		if (m_pages.size() < m_maxPages) {
+			m_pages.push_back(Page{
+				.packer = SkylinePacker{m_pageSize, m_pageSize},
+				.pixels = std::vector<std::uint8_t> (static_cast<std::size_t> (m_pageSize) * m_pageSize, 0u),
+				.dirty = {},
+				.lastUsed = m_frame
+			});
+		}
+		else {
+			// the quads of the current frame already point into the pages it used
+			const auto victim {std::ranges::min_element(m_pages, {}, &Page::lastUsed)};
+			if (victim->lastUsed == m_frame)
+				return std::nullopt;
+			index = static_cast<std::size_t> (victim - m_pages.begin());
+			std::erase_if(m_glyphs, [index] (const auto& glyph) noexcept {
+				return glyph.second.residency == CachedGlyph::Residency::ePacked && glyph.second.glyph.texture.layer == index;
+			});
+			// cleared entirely, stale texels around the new glyphs would bleed through the filtering
+			victim->packer.clear();
+			std::ranges::fill(victim->pixels, 0u);
+			victim->dirty = photon::Rect{.x = 0, .y = 0, .width = m_pageSize, .height = m_pageSize};
+		}
+		m_pages[index].lastUsed = m_frame;
+		const auto position {m_pages[index].packer.insert(width, height)};
+		if (!position)
+			return std::nullopt;
+		return std::pair{index, *position};
+	}
+
+
+	auto drawText(DrawList& drawList, GlyphAtlas& atlas, const TextInfos& textInfos) noexcept -> std::int32_t {
+		const float scale {textInfos.size / static_cast<float> (atlas.getPixelSize())};
+		float pen {static_cast<float> (textInfos.x)};
+		for (const char32_t codepoint : textInfos.text) {
+			const Glyph* glyph {atlas.getGlyph(codepoint)};
+			if (glyph == nullptr)
+				continue;
+			if (glyph->width > 0.f) {
+				drawList.distanceField(photon::Rect{
+					.x = static_cast<std::int32_t> (std::lround(pen + glyph->left * scale)),
+					.y = static_cast<std::int32_t> (std::lround(static_cast<float> (textInfos.baseline) - glyph->top * scale)),
+					.width = static_cast<std::uint32_t> (std::lround(glyph->width * scale)),
+					.height = static_cast<std::uint32_t> (std::lround(glyph->height * scale))
+				}, glyph->texture, textInfos.color);
+			}
+			pen += glyph->advance * scale;
+		}
+		return static_cast<std::int32_t> (std::lround(pen));
+	}
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <glad/glad.h>
+
+#include "charset.hpp"
+#include "color.hpp"
+#include "rect.hpp"
+#include "renderer/drawList.hpp"
+#include "renderer/skylinePacker.hpp"
+#include "utils/semantic.hpp"
+
+
+namespace photon::renderer {
+	// metrics are in pixels of the atlas, at its `pixelSize`
+	struct Glyph {
+		TextureRegion texture;
+		// from the pen position on the baseline to the top left corner of the bitmap, spread included
+		float left;
+		float top;
+		float width;
+		float height;
+		float advance;
+	};
+
+	// distance fields of glyphs, rasterized by FreeType into the layers of a single channel texture
+	// array. Text is drawn as quads of any size sampling it, without rasterizing again per size or
+	// per output scale. The glyphs of the charset are inserted upfront, any other one the first time
+	// it is asked for. Pages are added as needed up to the memory budget, past which the least
+	// recently used page is emptied to make room
+	class GlyphAtlas final {
+		public:
+			enum class CreateError {
+				eFreeTypeInitialization,
+				eFontLoading,
+				eFontSizing,
+			};
+			struct CreateInfos {
+				const photon::Charset& charset;
+				std::string_view fontPath;
+				// size the fields are rasterized at, larger keeps sharper corners once scaled up
+				std::uint32_t pixelSize {32u};
+				// distance in pixels covered by the field on each side of the edge
+				std::uint32_t spread {4u};
+				std::uint32_t pageSize {512u};
+				// in bytes, at least one page is always kept
+				std::size_t memoryBudget {4uz * 1024uz * 1024uz};
+			};
+
+			GlyphAtlas(const GlyphAtlas&) = delete;
+			auto operator=(const GlyphAtlas&) -> GlyphAtlas& = delete;
+			auto operator=(GlyphAtlas&&) -> GlyphAtlas& = delete;
+
+			GlyphAtlas(GlyphAtlas&& other) noexcept;
+			~GlyphAtlas() noexcept;
+
+			// needs a current GL 4.6 context
+			[[nodiscard]]
+			static auto create(const CreateInfos& createInfos) noexcept -> std::expected<GlyphAtlas, CreateError>;
+
+			// rasterizes the glyph if needed and marks its page as used by the current frame, which
+			// protects it from eviction until the next `flush`. `nullptr` if the font lacks it, if it
+			// can't be rendered or if every page is used by the current frame while the budget is
+			// reached. The pointer is valid until the next call
+			auto getGlyph(char32_t codepoint) noexcept -> const Glyph*;
+			// upload the glyphs inserted since the last call, at most one upload per page, and start
+			// a new frame. Must be called after the draw list of a frame is built and before it is
+			// rendered, as the texture may be reallocated
+			auto flush() noexcept -> void;
+
+			inline auto getTexture() const noexcept -> GLuint {
+				return m_texture;
+			}
+			inline auto getPixelSize() const noexcept -> std::uint32_t {
+				return m_pixelSize;
+			}
+			inline auto getLineHeight() const noexcept -> float {
+				return m_lineHeight;
+			}
+			inline auto getPageCount() const noexcept -> std::size_t {
+				return m_pages.size();
+			}
+			// bumped by every `flush` that changed texels, an evicted page may be refilled with other
+			// glyphs at the same coordinates. See `Renderer::setTexture`
+			inline auto getGeneration() const noexcept -> std::uint64_t {
+				return m_generation;
+			}
+
+		private:
+			struct Page {
+				SkylinePacker packer;
+				// CPU copy of the layer, the dirty part is uploaded on `flush`
+				std::vector<std::uint8_t> pixels;
+				photon::Rect dirty;
+				std::uint64_t lastUsed;
+			};
+			struct CachedGlyph {
+				enum class Residency : std::uint8_t {
+					// remembered so that the font isn't searched again, never handed out
+					eMissing,
+					// only an advance, lives in no page
+					eBlank,
+					ePacked,
+				};
+
+				Glyph glyph;
+				Residency residency;
+			};
+
+			GlyphAtlas() noexcept = default;
+
+			auto insert(char32_t codepoint) noexcept -> const CachedGlyph*;
+			// a page with room for a `width`x`height` rect, evicting one if needed
+			auto allocate(std::uint32_t width, std::uint32_t height) noexcept -> std::optional<std::pair<std::size_t, PackedPosition>>;
+
+			photon::utils::Owned<FT_Library> m_library {};
+			photon::utils::Owned<FT_Face> m_face {};
+			GLuint m_texture {0u};
+			std::size_t m_textureLayers {0uz};
+			std::uint32_t m_pixelSize {0u};
+			std::uint32_t m_pageSize {0u};
+			std::size_t m_maxPages {0uz};
+			float m_lineHeight {0.f};
+			std::uint64_t m_frame {0u};
+			std::uint64_t m_generation {0u};
+			std::vector<Page> m_pages {};
+			std::unordered_map<char32_t, CachedGlyph> m_glyphs {};
+	};
+
+	struct TextInfos {
+		std::u32string_view text;
+		// pen position on the baseline
+		std::int32_t x;
+		std::int32_t baseline;
+		float size;
+		photon::Color color;
+	};
+
+	// record `text` as distance field quads, codepoints the atlas can't provide are skipped. Returns
+	// the pen position after the last glyph
+	auto drawText(DrawList& drawList, GlyphAtlas& atlas, const TextInfos& textInfos) noexcept -> std::int32_t;
+}
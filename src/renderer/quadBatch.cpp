@@ -0,0 +1,247 @@
+#include "renderer/quadBatch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#include <glad/glad.h>
+
+
+namespace photon::renderer {
+	static constexpr GLuint INSTANCE_BINDING {0u};
+	// a bit more than 9k quads per frame before a frame spills over the next region
+	static constexpr std::size_t STREAM_REGION_SIZE {256uz * 1024uz};
+	// below that, moving to the next region is cheaper than splitting the draw
+	static constexpr std::size_t MIN_RESERVED_QUADS {256uz};
+
+	// the quad is a 4 vertices strip whose corners come from `gl_VertexID`, no vertex buffer needed
+	static constexpr const char* VERTEX_SHADER {R"(#version 460 core
+		layout(location = 0) in ivec2 a_position;
+		layout(location = 1) in uvec2 a_size;
+		layout(location = 2) in uint a_color;
+		layout(location = 3) in uvec2 a_shape;
+		layout(location = 4) in vec4 a_uv;
+		layout(location = 5) in uvec2 a_texture;
+
+		uniform vec2 u_viewport;
+
+		out vec2 v_local;
+		out vec2 v_uv;
+		flat out vec2 v_halfSize;
+		flat out vec2 v_shape;
+		flat out vec4 v_color;
+		flat out uint v_flags;
+		flat out float v_layer;
+
+		void main() {
+			const vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+			const vec2 size = vec2(a_size);
+			const vec2 pixel = vec2(a_position) + corner * size;
+			gl_Position = vec4(pixel / u_viewport * vec2(2.0, -2.0) + vec2(-1.0, 1.0), 0.0, 1.0);
+
+			v_local = (corner - 0.5) * size;
+			v_uv = mix(a_uv.xy, a_uv.zw, corner);
+			v_halfSize = size * 0.5;
+			v_shape = vec2(a_shape);
+			v_color = vec4(
+				(a_color >> 16u) & 0xffu,
+				(a_color >> 8u) & 0xffu,
+				a_color & 0xffu,
+				a_color >> 24u
+			) / 255.0;
+			v_flags = a_texture.x;
+			v_layer = float(a_texture.y);
+		}
+	)"};
+
+	static constexpr const char* FRAGMENT_SHADER {R"(#version 460 core
+		const uint TEXTURED = 1u;
+		const uint DISTANCE_FIELD = 2u;
+
+		layout(binding = 0) uniform sampler2DArray u_texture;
+
+		in vec2 v_local;
+		in vec2 v_uv;
+		flat in vec2 v_halfSize;
+		flat in vec2 v_shape;
+		flat in vec4 v_color;
+		flat in uint v_flags;
+		flat in float v_layer;
+
+		out vec4 o_color;
+
+		void main() {
+			// signed distance to the edge of the rounded rect, negative inside
+			const float radius = min(v_shape.x, min(v_halfSize.x, v_halfSize.y));
+			const vec2 q = abs(v_local) - v_halfSize + radius;
+			const float distance = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+			float coverage = clamp(0.5 - distance, 0.0, 1.0);
+			if (v_shape.y > 0.0)
+				coverage *= clamp(0.5 + distance + v_shape.y, 0.0, 1.0);
+
+			vec4 color = v_color;
+			if ((v_flags & TEXTURED) != 0u)
+				color *= texture(u_texture, vec3(v_uv, v_layer));
+			else if ((v_flags & DISTANCE_FIELD) != 0u) {
+				// antialiased over about a pixel, whatever the scale the field is drawn at
+				const float field = texture(u_texture, vec3(v_uv, v_layer)).r;
+				const float width = max(fwidth(field), 1e-4);
+				color.a *= smoothstep(0.5 - width, 0.5 + width, field);
+			}
+			// premultiplied, as the compositor expects
+			o_color = vec4(color.rgb * color.a, color.a) * coverage;
+		}
+	)"};
+
+	static auto compileShader(GLenum type, const char* source) noexcept -> GLuint {
+		const GLuint shader {glCreateShader(type)};
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+		GLint status {GL_FALSE};
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+		if (status == GL_TRUE)
+			return shader;
+		glDeleteShader(shader);
+		return 0u;
+	}
+
+	QuadBatch::QuadBatch(StreamBuffer&& stream) noexcept :
+		m_stream {std::move(stream)}
+	{}
+
+	QuadBatch::QuadBatch(QuadBatch&& other) noexcept :
+		m_stream {std::move(other.m_stream)},
+		m_program {std::exchange(other.m_program, 0u)},
+		m_vertexArray {std::exchange(other.m_vertexArray, 0u)},
+		m_viewportLocation {other.m_viewportLocation},
+		m_texture {other.m_texture},
+		m_viewportWidth {other.m_viewportWidth},
+		m_viewportHeight {other.m_viewportHeight},
+		m_mapped {std::exchange(other.m_mapped, nullptr)},
+		m_offset {other.m_offset},
+		m_capacity {std::exchange(other.m_capacity, 0uz)},
+		m_count {std::exchange(other.m_count, 0uz)}
+	{}
+
+	QuadBatch::~QuadBatch() noexcept {
+		if (m_vertexArray != 0u)
+			glDeleteVertexArrays(1, &m_vertexArray);
+		if (m_program != 0u)
+			glDeleteProgram(m_program);
+	}
+
+	auto QuadBatch::create() noexcept -> std::expected<QuadBatch, CreateError> {
+		auto stream {StreamBuffer::create(StreamBuffer::CreateInfos{.regionSize = STREAM_REGION_SIZE})};
+		if (!stream)
+			return std::unexpected(CreateError::eStreamBufferMapping);
+		QuadBatch batch {std::move(*stream)};
+
+		const GLuint vertexShader {compileShader(GL_VERTEX_SHADER, VERTEX_SHADER)};
+		if (vertexShader == 0u)
+			return std::unexpected(CreateError::eVertexShaderCompilation);
+		const GLuint fragmentShader {compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER)};
+		if (fragmentShader == 0u) {
+			glDeleteShader(vertexShader);
+			return std::unexpected(CreateError::eFragmentShaderCompilation);
+		}
+		batch.m_program = glCreateProgram();
+		glAttachShader(batch.m_program, vertexShader);
+		glAttachShader(batch.m_program, fragmentShader);
+		glLinkProgram(batch.m_program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+		GLint status {GL_FALSE};
+		glGetProgramiv(batch.m_program, GL_LINK_STATUS, &status);
+		if (status != GL_TRUE)
+			return std::unexpected(CreateError::eProgramLinking);
+		batch.m_viewportLocation = glGetUniformLocation(batch.m_program, "u_viewport");
+
+		glCreateVertexArrays(1, &batch.m_vertexArray);
+		glVertexArrayBindingDivisor(batch.m_vertexArray, INSTANCE_BINDING, 1u);
+		const auto integerAttribute {[&batch] (GLuint location, GLint size, GLenum type, std::size_t offset) noexcept {
+			glEnableVertexArrayAttrib(batch.m_vertexArray, location);
+			glVertexArrayAttribIFormat(batch.m_vertexArray, location, size, type, static_cast<GLuint> (offset));
+			glVertexArrayAttribBinding(batch.m_vertexArray, location, INSTANCE_BINDING);
+		}};
+		integerAttribute(0u, 2, GL_SHORT, offsetof(QuadInstance, x));
+		integerAttribute(1u, 2, GL_UNSIGNED_SHORT, offsetof(QuadInstance, width));
+		integerAttribute(2u, 1, GL_UNSIGNED_INT, offsetof(QuadInstance, color));
+		integerAttribute(3u, 2, GL_UNSIGNED_SHORT, offsetof(QuadInstance, radius));
+		glEnableVertexArrayAttrib(batch.m_vertexArray, 4u);
+		glVertexArrayAttribFormat(batch.m_vertexArray, 4u, 4, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(QuadInstance, u0));
+		glVertexArrayAttribBinding(batch.m_vertexArray, 4u, INSTANCE_BINDING);
+		integerAttribute(5u, 2, GL_UNSIGNED_SHORT, offsetof(QuadInstance, flags));
+		return batch;
+	}
+
+	auto toQuadInstance(const DrawCommand& command) noexcept -> QuadInstance {
+		// indexed by `DrawCommand::Sampling`
+		static constexpr std::array<std::uint16_t, 3uz> SAMPLING_FLAGS {
+			QuadInstance::eNone,
+			QuadInstance::eTextured,
+			QuadInstance::eDistanceField
+		};
+		const auto toPosition {[] (std::int32_t value) noexcept -> std::int16_t {
+			return static_cast<std::int16_t> (std::clamp<std::int32_t> (
+				value,
+				std::numeric_limits<std::int16_t>::min(),
+				std::numeric_limits<std::int16_t>::max()
+			));
+		}};
+		const auto toSize {[] (std::uint32_t value) noexcept -> std::uint16_t {
+			return static_cast<std::uint16_t> (std::min<std::uint32_t> (value, std::numeric_limits<std::uint16_t>::max()));
+		}};
+
+		return QuadInstance{
+			.x = toPosition(command.rect.x),
+			.y = toPosition(command.rect.y),
+			.width = toSize(command.rect.width),
+			.height = toSize(command.rect.height),
+			.color = command.color.into<photon::ARGBColor> ().into<std::uint32_t> (),
+			.radius = command.radius,
+			.borderWidth = command.borderWidth,
+			.u0 = command.texture.u0,
+			.v0 = command.texture.v0,
+			.u1 = command.texture.u1,
+			.v1 = command.texture.v1,
+			.flags = SAMPLING_FLAGS[std::to_underlying(command.sampling)],
+			.layer = command.texture.layer
+		};
+	}
+
+	auto QuadBatch::flush() noexcept -> void {
+		if (m_count == 0uz)
+			return;
+		m_stream.commit(m_count * sizeof(QuadInstance));
+		glUseProgram(m_program);
+		glProgramUniform2f(
+			m_program,
+			m_viewportLocation,
+			static_cast<GLfloat> (m_viewportWidth),
+			static_cast<GLfloat> (m_viewportHeight)
+		);
+		glBindVertexArray(m_vertexArray);
+		glBindTextureUnit(0u, m_texture);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		glVertexArrayVertexBuffer(m_vertexArray, INSTANCE_BINDING, m_stream.getBuffer(), m_offset, sizeof(QuadInstance));
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei> (m_count));
+		glDisable(GL_BLEND);
+		// the rest of the region is reserved again by the next push
+		m_mapped = nullptr;
+		m_capacity = 0uz;
+		m_count = 0uz;
+	}
+
+	auto QuadBatch::reserve() noexcept -> void {
+		this->flush();
+		const std::size_t minimumSize {std::min(MIN_RESERVED_QUADS * sizeof(QuadInstance), m_stream.getRegionSize())};
+		// can't fail, the minimum is capped to the region size
+		const auto reservation {m_stream.reserve(minimumSize, alignof(QuadInstance))};
+		m_mapped = reservation->memory.data();
+		m_offset = reservation->offset;
+		m_capacity = reservation->memory.size() / sizeof(QuadInstance);
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+
+#include <glad/glad.h>
+
+#include "renderer/drawList.hpp"
+#include "renderer/streamBuffer.hpp"
+
+
+namespace photon::renderer {
+	// per-instance data of a quad, 28 bytes. Positions are in pixels from the top left corner of
+	// the window, the color is an `ARGBColor` and the uvs are normalized to the full range
+	struct QuadInstance {
+		enum Flags : std::uint16_t {
+			eNone = 0u,
+			eTextured = 1u << 0u,
+			// the red channel of the texel is a distance field, edge at 0.5
+			eDistanceField = 1u << 1u,
+		};
+
+		std::int16_t x;
+		std::int16_t y;
+		std::uint16_t width;
+		std::uint16_t height;
+		std::uint32_t color;
+		std::uint16_t radius;
+		// 0 fills the quad
+		std::uint16_t borderWidth;
+		std::uint16_t u0;
+		std::uint16_t v0;
+		std::uint16_t u1;
+		std::uint16_t v1;
+		std::uint16_t flags;
+		std::uint16_t layer;
+	};
+	static_assert(sizeof(QuadInstance) == 28uz);
+
+	// `command` must not be an `eFill`. Out of range coordinates are clamped
+	auto toQuadInstance(const DrawCommand& command) noexcept -> QuadInstance;
+
+	// quads accumulated over a frame and drawn with a single instanced call. Rounded corners and
+	// borders are computed in the fragment shader from a signed distance, textured quads sample
+	// the `sampler2DArray` bound to unit 0, either as colors or as a distance field
+	class QuadBatch final {
+		public:
+			enum class CreateError {
+				eVertexShaderCompilation,
+				eFragmentShaderCompilation,
+				eProgramLinking,
+				eStreamBufferMapping,
+			};
+
+			QuadBatch(const QuadBatch&) = delete;
+			auto operator=(const QuadBatch&) -> QuadBatch& = delete;
+			auto operator=(QuadBatch&&) -> QuadBatch& = delete;
+
+			QuadBatch(QuadBatch&& other) noexcept;
+			~QuadBatch() noexcept;
+
+			// needs a current GL 4.6 context
+			[[nodiscard]]
+			static auto create() noexcept -> std::expected<QuadBatch, CreateError>;
+
+			// written straight into the mapped stream buffer, drawing what is pending first when the
+			// current reservation is full
+			inline auto push(const QuadInstance& quad) noexcept -> void {
+				if (m_count == m_capacity)
+					this->reserve();
+				std::memcpy(m_mapped + m_count * sizeof(QuadInstance), &quad, sizeof(QuadInstance));
+				++m_count;
+			}
+			inline auto getSize() const noexcept -> std::size_t {
+				return m_count;
+			}
+			inline auto setViewport(std::uint32_t width, std::uint32_t height) noexcept -> void {
+				m_viewportWidth = width;
+				m_viewportHeight = height;
+			}
+			// 0 unbinds the texture
+			inline auto setTexture(GLuint texture) noexcept -> void {
+				m_texture = texture;
+			}
+
+			// draw every pushed quad, then empty the batch
+			auto flush() noexcept -> void;
+			// after the last flush of a frame
+			inline auto endFrame() noexcept -> void {
+				this->flush();
+				m_stream.endFrame();
+			}
+
+		private:
+			QuadBatch(StreamBuffer&& stream) noexcept;
+
+			auto reserve() noexcept -> void;
+
+			StreamBuffer m_stream;
+			GLuint m_program {0u};
+			GLuint m_vertexArray {0u};
+			GLint m_viewportLocation {-1};
+			GLuint m_texture {0u};
+			std::uint32_t m_viewportWidth {0u};
+			std::uint32_t m_viewportHeight {0u};
+			// current reservation in the stream buffer, `m_count` quads of it are written
+			std::byte* m_mapped {nullptr};
+			GLintptr m_offset {0};
+			std::size_t m_capacity {0uz};
+			std::size_t m_count {0uz};
+	};
+}
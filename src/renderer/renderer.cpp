@@ -0,0 +1,76 @@
+#include "renderer/renderer.hpp"
+
+#include <cstdint>
+#include <utility>
+
+#include <glad/glad.h>
+
+
+namespace photon::renderer {
+	Renderer::Renderer(QuadBatch&& quads) noexcept :
+		m_quads {std::move(quads)},
+		m_texture {0u},
+		m_textureGeneration {0u},
+		m_lastFrame {std::nullopt},
+		m_statistics {}
+	{}
+
+	auto Renderer::create() noexcept -> std::expected<Renderer, CreateError> {
+		auto quads {QuadBatch::create()};
+		if (!quads)
+			return std::unexpected(quads.error());
+		return Renderer{std::move(*quads)};
+	}
+
+	auto Renderer::render(photon::wayland::Window& window, const DrawList& drawList) noexcept
+		-> std::expected<bool, photon::wayland::Window::PresentError>
+	{
+		const PresentedFrame frame {
+			.hash = drawList.getHash(),
+			.width = window.getWidth(),
+			.height = window.getHeight(),
+			.texture = m_texture,
+			.textureGeneration = m_textureGeneration
+		};
+		// a resize invalidates the whole buffer whatever the list says, and so does a change of the
+		// texels its regions point to
+		if (m_lastFrame == frame) {
+			window.skipFrame();
+			++m_statistics.skipped;
+			return false;
+		}
+
+		const photon::Rect clip {window.beginFrame().getBounds()};
+		this->execute(window, drawList, clip);
+		if (auto result {window.present()}; !result) {
+			// whatever reached the buffer can't be trusted to match the list anymore
+			m_lastFrame = std::nullopt;
+			return std::unexpected(result.error());
+		}
+		m_lastFrame = frame;
+		++m_statistics.presented;
+		return true;
+	}
+
+	auto Renderer::execute(photon::wayland::Window& window, const DrawList& drawList, const photon::Rect& clip) noexcept -> void {
+		const std::uint32_t width {window.getWidth()};
+		const std::uint32_t height {window.getHeight()};
+
+		// the size is only known once configured and changes on every resize
+		glViewport(0, 0, static_cast<GLsizei> (width), static_cast<GLsizei> (height));
+		m_quads.setViewport(width, height);
+		for (const auto& command : drawList.getCommands()) {
+			if (command.type == DrawCommand::Type::eFill) {
+				// quads recorded before the fill must land below it
+				m_quads.flush();
+				window.fill(command.color);
+				continue;
+			}
+			// the scissor drops the fragments anyway, culling saves the vertex work
+			if (!command.rect.intersects(clip))
+				continue;
+			m_quads.push(toQuadInstance(command));
+		}
+		m_quads.endFrame();
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <optional>
+
+#include <glad/glad.h>
+
+#include "renderer/drawList.hpp"
+#include "renderer/quadBatch.hpp"
+#include "rect.hpp"
+#include "wayland/window.hpp"
+
+
+namespace photon::renderer {
+	struct RendererStatistics {
+		std::uint64_t presented;
+		// frames whose draw list matched the last presented one, neither rendered nor swapped
+		std::uint64_t skipped;
+	};
+
+	// turns draw lists into frames of a window. A frame identical to the one on screen is dropped
+	// before touching GL, so an idle bar doesn't wake the GPU nor the compositor up
+	class Renderer final {
+		public:
+			using CreateError = QuadBatch::CreateError;
+
+			Renderer(const Renderer&) = delete;
+			auto operator=(const Renderer&) -> Renderer& = delete;
+			auto operator=(Renderer&&) -> Renderer& = delete;
+
+			Renderer(Renderer&&) noexcept = default;
+			~Renderer() noexcept = default;
+
+			// needs the context of the window to be current
+			[[nodiscard]]
+			static auto create() noexcept -> std::expected<Renderer, CreateError>;
+
+			// returns whether a frame was actually presented
+			auto render(photon::wayland::Window& window, const DrawList& drawList) noexcept
+				-> std::expected<bool, photon::wayland::Window::PresentError>;
+
+			// texture array sampled by the textured quads. `generation` must change whenever its
+			// texels do, a draw list identical to the last one is otherwise taken as the same frame.
+			// Pass `GlyphAtlas::getGeneration` after each `GlyphAtlas::flush`
+			inline auto setTexture(GLuint texture, std::uint64_t generation = 0u) noexcept -> void {
+				m_quads.setTexture(texture);
+				m_texture = texture;
+				m_textureGeneration = generation;
+			}
+
+			inline auto getStatistics() const noexcept -> const RendererStatistics& {
+				return m_statistics;
+			}
+
+		private:
+			struct PresentedFrame {
+				std::uint64_t hash;
+				std::uint32_t width;
+				std::uint32_t height;
+				GLuint texture;
+				std::uint64_t textureGeneration;
+
+				constexpr auto operator==(const PresentedFrame&) const noexcept -> bool = default;
+			};
+
+			Renderer(QuadBatch&& quads) noexcept;
+
+			auto execute(photon::wayland::Window& window, const DrawList& drawList, const photon::Rect& clip) noexcept -> void;
+
+			QuadBatch m_quads;
+			GLuint m_texture;
+			std::uint64_t m_textureGeneration;
+			std::optional<PresentedFrame> m_lastFrame;
+			RendererStatistics m_statistics;
+	};
+}
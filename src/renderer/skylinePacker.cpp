@@ -0,0 +1,82 @@
+#include "renderer/skylinePacker.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+
+namespace photon::renderer {
+	SkylinePacker::SkylinePacker(std::uint32_t width, std::uint32_t height) noexcept :
+		m_width {width},
+		m_height {height},
+		m_skyline {Segment{.x = 0u, .y = 0u, .width = width}}
+	{}
+
+	auto SkylinePacker::insert(std::uint32_t width, std::uint32_t height) noexcept -> std::optional<PackedPosition> {
+		if (width == 0u || height == 0u)
+			return std::nullopt;
+		std::size_t bestIndex {m_skyline.size()};
+		std::uint32_t bestY {std::numeric_limits<std::uint32_t>::max()};
+		std::uint32_t bestWidth {std::numeric_limits<std::uint32_t>::max()};
+		for (std::size_t i {0uz}; i < m_skyline.size(); ++i) {
+			const auto y {this->fit(i, width, height)};
+			if (!y)
+				continue;
+			if (*y < bestY || (*y == bestY && m_skyline[i].width < bestWidth)) {
+				bestIndex = i;
+				bestY = *y;
+				bestWidth = m_skyline[i].width;
+			}
+		}
+		if (bestIndex == m_skyline.size())
+			return std::nullopt;
+
+		const PackedPosition position {.x = m_skyline[bestIndex].x, .y = bestY};
+		m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t> (bestIndex), Segment{
+			.x = position.x,
+			.y = position.y + height,
+			.width = width
+		});
+		// the segments now below the new one shrink or go away
+		const std::uint32_t right {position.x + width};
+		for (std::size_t i {bestIndex + 1uz}; i < m_skyline.size();) {
+			Segment& segment {m_skyline[i]};
+			if (segment.x >= right)
+				break;
+			const std::uint32_t overlap {right - segment.x};
+			if (overlap < segment.width) {
+				segment.x += overlap;
+				segment.width -= overlap;
+				break;
+			}
+			m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t> (i));
+		}
+		for (std::size_t i {0uz}; i + 1uz < m_skyline.size();) {
+			if (m_skyline[i].y != m_skyline[i + 1uz].y) {
+				++i;
+				continue;
+			}
+			m_skyline[i].width += m_skyline[i + 1uz].width;
+			m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t> (i + 1uz));
+		}
+		return position;
+	}
+
+	auto SkylinePacker::clear() noexcept -> void {
+		m_skyline.assign(1uz, Segment{.x = 0u, .y = 0u, .width = m_width});
+	}
+
+	auto SkylinePacker::fit(std::size_t index, std::uint32_t width, std::uint32_t height) const noexcept -> std::optional<std::uint32_t> {
+		if (m_skyline[index].x + width > m_width)
+			return std::nullopt;
+		std::uint32_t y {0u};
+		std::uint32_t remaining {width};
+		for (std::size_t i {index}; remaining > 0u; ++i) {
+			y = std::max(y, m_skyline[i].y);
+			if (y + height > m_height)
+				return std::nullopt;
+			remaining -= std::min(remaining, m_skyline[i].width);
+		}
+		return y;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+
+namespace photon::renderer {
+	struct PackedPosition {
+		std::uint32_t x;
+		std::uint32_t y;
+	};
+
+	// bottom-left skyline packing of rects into a fixed size area. Only the top edge of what was
+	// placed so far is kept, so inserting is linear in the number of skyline segments and rects
+	// can't be removed one by one, only all at once
+	class SkylinePacker final {
+		public:
+			SkylinePacker(std::uint32_t width, std::uint32_t height) noexcept;
+			~SkylinePacker() noexcept = default;
+			SkylinePacker(const SkylinePacker&) = delete;
+			auto operator=(const SkylinePacker&) -> SkylinePacker& = delete;
+			SkylinePacker(SkylinePacker&&) noexcept = default;
+			auto operator=(SkylinePacker&&) noexcept -> SkylinePacker& = default;
+
+			// the lowest then narrowest spot, `std::nullopt` once full
+			auto insert(std::uint32_t width, std::uint32_t height) noexcept -> std::optional<PackedPosition>;
+			auto clear() noexcept -> void;
+
+		private:
+			struct Segment {
+				std::uint32_t x;
+				std::uint32_t y;
+				std::uint32_t width;
+			};
+
+			// height at which a `width`x`height` rect fits when starting at segment `index`
+			auto fit(std::size_t index, std::uint32_t width, std::uint32_t height) const noexcept -> std::optional<std::uint32_t>;
+
+			std::uint32_t m_width;
+			std::uint32_t m_height;
+			std::vector<Segment> m_skyline;
+	};
+}
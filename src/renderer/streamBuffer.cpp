@@ -0,0 +1,94 @@
+#include "renderer/streamBuffer.hpp"
+
+#include <cstdint>
+#include <utility>
+
+#include <glad/glad.h>
+
+
+namespace photon::renderer {
+	static constexpr GLbitfield MAPPING_FLAGS {GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT};
+	static constexpr GLuint64 FENCE_TIMEOUT {1'000'000'000u};
+
+	StreamBuffer::StreamBuffer(StreamBuffer&& other) noexcept :
+		m_buffer {std::exchange(other.m_buffer, 0u)},
+		m_memory {std::exchange(other.m_memory, nullptr)},
+		m_regionSize {other.m_regionSize},
+		m_region {other.m_region},
+		m_used {other.m_used},
+		m_open {other.m_open},
+		m_fences {std::move(other.m_fences)}
+	{
+		other.m_fences.clear();
+	}
+
+	StreamBuffer::~StreamBuffer() noexcept {
+		for (GLsync fence : m_fences) {
+			if (fence != nullptr)
+				glDeleteSync(fence);
+		}
+		if (m_buffer == 0u)
+			return;
+		if (m_memory != nullptr)
+			glUnmapNamedBuffer(m_buffer);
+		glDeleteBuffers(1, &m_buffer);
+	}
+
+	auto StreamBuffer::create(const CreateInfos& createInfos) noexcept -> std::expected<StreamBuffer, CreateError> {
+		StreamBuffer buffer {};
+		buffer.m_regionSize = createInfos.regionSize;
+		buffer.m_fences.resize(createInfos.regionCount, nullptr);
+		const auto size {static_cast<GLsizeiptr> (createInfos.regionSize * createInfos.regionCount)};
+		glCreateBuffers(1, &buffer.m_buffer);
+		glNamedBufferStorage(buffer.m_buffer, size, nullptr, MAPPING_FLAGS);
+		buffer.m_memory = static_cast<std::byte*> (glMapNamedBufferRange(buffer.m_buffer, 0, size, MAPPING_FLAGS));
+		if (buffer.m_memory == nullptr)
+			return std::unexpected(CreateError::eBufferMapping);
+		return buffer;
+	}
+
+	auto StreamBuffer::reserve(std::size_t minimumSize, std::size_t alignment) noexcept -> std::optional<StreamAllocation> {
+		if (minimumSize > m_regionSize)
+			return std::nullopt;
+		if (!m_open)
+			this->openRegion();
+		std::size_t start {(m_used + alignment - 1uz) / alignment * alignment};
+		if (start + minimumSize > m_regionSize) {
+			this->closeRegion();
+			this->openRegion();
+			start = 0uz;
+		}
+		m_used = start;
+		const std::size_t offset {m_region * m_regionSize + start};
+		return StreamAllocation{
+			.memory = std::span{m_memory + offset, m_regionSize - start},
+			.offset = static_cast<GLintptr> (offset)
+		};
+	}
+
+	auto StreamBuffer::endFrame() noexcept -> void {
+		// nothing was written, the region can keep going next frame
+		if (!m_open)
+			return;
+		this->closeRegion();
+	}
+
+	auto StreamBuffer::openRegion() noexcept -> void {
+		GLsync& fence {m_fences[m_region]};
+		if (fence != nullptr) {
+			// the flush is only needed once, later waits would spin on an already submitted fence
+			GLbitfield flags {GL_SYNC_FLUSH_COMMANDS_BIT};
+			while (glClientWaitSync(fence, flags, FENCE_TIMEOUT) == GL_TIMEOUT_EXPIRED)
+				flags = 0u;
+			glDeleteSync(std::exchange(fence, nullptr));
+		}
+		m_used = 0uz;
+		m_open = true;
+	}
+
+	auto StreamBuffer::closeRegion() noexcept -> void {
+		m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0u);
+		m_region = (m_region + 1uz) % m_fences.size();
+		m_open = false;
+	}
+}
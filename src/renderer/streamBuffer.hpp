@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glad/glad.h>
+
+
+namespace photon::renderer {
+	struct StreamAllocation {
+		std::span<std::byte> memory;
+		// offset of `memory` within the buffer, to bind it
+		GLintptr offset;
+	};
+
+	// persistently and coherently mapped buffer, split in regions written in turn by the CPU. Each
+	// region is fenced once submitted and only reused after the GPU is done reading it, so writing
+	// never allocates nor stalls on an implicit sync, as long as the GPU keeps up
+	class StreamBuffer final {
+		public:
+			enum class CreateError {
+				eBufferMapping,
+			};
+			struct CreateInfos {
+				std::size_t regionSize;
+				// frames that can be in flight at once
+				std::size_t regionCount {3uz};
+			};
+
+			StreamBuffer(const StreamBuffer&) = delete;
+			auto operator=(const StreamBuffer&) -> StreamBuffer& = delete;
+			auto operator=(StreamBuffer&&) -> StreamBuffer& = delete;
+
+			StreamBuffer(StreamBuffer&& other) noexcept;
+			~StreamBuffer() noexcept;
+
+			[[nodiscard]]
+			static auto create(const CreateInfos& createInfos) noexcept -> std::expected<StreamBuffer, CreateError>;
+
+			// the rest of the current region, to be written in place. Moves to the next region early
+			// when less than `minimumSize` bytes are left, waiting for the GPU if needed.
+			// `std::nullopt` if `minimumSize` doesn't fit in a region. Nothing is consumed until
+			// `commit`
+			auto reserve(std::size_t minimumSize, std::size_t alignment) noexcept -> std::optional<StreamAllocation>;
+			// consume the first `size` bytes of the last reservation
+			inline auto commit(std::size_t size) noexcept -> void {
+				m_used += size;
+			}
+			// fence what was allocated since the last call, must follow the draw calls reading it
+			auto endFrame() noexcept -> void;
+
+			inline auto getBuffer() const noexcept -> GLuint {
+				return m_buffer;
+			}
+			inline auto getRegionSize() const noexcept -> std::size_t {
+				return m_regionSize;
+			}
+
+		private:
+			StreamBuffer() noexcept = default;
+
+			auto openRegion() noexcept -> void;
+			auto closeRegion() noexcept -> void;
+
+			GLuint m_buffer {0u};
+			std::byte* m_memory {nullptr};
+			std::size_t m_regionSize {0uz};
+			std::size_t m_region {0uz};
+			std::size_t m_used {0uz};
+			// whether the current region was waited for and is being written
+			bool m_open {false};
+			std::vector<GLsync> m_fences {};
+	};
+}
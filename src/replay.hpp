@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#include "event.hpp"
+#include "events/record.hpp"
+
+
+namespace photon {
+	struct ReplayInfos {
+		// 2 replays twice as fast as recorded, 0 pushes everything as fast as possible
+		double speed {1.0};
+	};
+
+	namespace internals::events {
+		template <typename Queue, typename EventType>
+		auto replayEvent(Queue& queue, const photon::events::RecordedEvent& event) noexcept -> bool {
+			using Value = typename get_event_value<decltype(EventType::key), EventType>::type;
+			if (event.key != static_cast<std::int64_t> (std::to_underlying(EventType::key)))
+				return false;
+			auto value {photon::events::Serializer<Value>::read(event.payload)};
+			if (!value)
+				return false;
+			(void)queue.template push<EventType::key> (std::move(*value));
+			return true;
+		}
+	}
+
+	// push back every event of `reader` into `queue` from the calling thread, keeping the original
+	// spacing between them. Events of unknown keys or with unreadable payloads are skipped, the
+	// number of events actually pushed is returned
+	template <EventQueueConfig config, event_key Key, internals::events::event_of_key<Key>... Events>
+	requires (photon::events::serializable<typename internals::events::get_event_value<Key, Events>::type> && ...)
+	auto replay(
+		BasicEventQueue<config, Key, Events...>& queue,
+		photon::events::EventLogReader& reader,
+		const ReplayInfos& replayInfos = {}
+	) noexcept -> std::size_t {
+		const auto start {std::chrono::steady_clock::now()};
+		std::size_t count {0uz};
+		while (auto event {reader.next()}) {
+			if (replayInfos.speed > 0.0) {
+				std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration> (
+					std::chrono::duration<double, std::nano> (static_cast<double> (event->timestamp.count()) / replayInfos.speed)
+				));
+			}
+			if ((internals::events::replayEvent<BasicEventQueue<config, Key, Events...>, Events> (queue, *event) || ...))
+				++count;
+		}
+		return count;
+	}
+}
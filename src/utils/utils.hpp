@@ -9,6 +9,9 @@
 
 
 namespace photon::utils {
+	// hardcoded instead of `std::hardware_destructive_interference_size` to keep the ABI stable
+	inline constexpr std::size_t CACHE_LINE_SIZE {64uz};
+
 	template <typename T>
 	constexpr auto makeArray(auto&&... datas) noexcept -> std::array<T, sizeof...(datas)> {
 		return std::array<T, sizeof...(datas)> {std::forward<decltype(datas)> (datas)...};
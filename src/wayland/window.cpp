@@ -1,10 +1,15 @@
 #include "wayland/window.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <expected>
 #include <map>
+#include <mutex>
 #include <print>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 
 #include <fcntl.h>
 #include <sys/mman.h>
@@ -12,6 +17,7 @@
 
 #include <glad/glad.h>
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 #include <wayland-client-core.h>
 #include <wayland-client-protocol.h>
 #include <wayland-egl-core.h>
@@ -69,6 +75,15 @@ namespace photon::wayland {
 	}
 #endif
 
+	// render as soon as the compositor lets us, coalescing everything damaged until then
+	static auto setDirty(Window::FrameState& frameState) noexcept -> void {
+		if (frameState.dirty)
+			return;
+		frameState.dirty = true;
+		if (frameState.frameCallback == nullptr && frameState.onFrameReady)
+			frameState.onFrameReady();
+	}
+
 	static const zwlr_layer_surface_v1_listener layerSurfaceListener {
 		.configure = [](
 			void* data,
@@ -78,14 +93,33 @@ namespace photon::wayland {
 			uint32_t height
 		) {
 			std::println("configure wlr surface, {}x{}", width, height);
-			auto eglWindow {static_cast<wl_egl_window*> (data)};
-			wl_egl_window_resize(eglWindow, width, height, 0, 0);
+			auto frameState {static_cast<Window::FrameState*> (data)};
+			wl_egl_window_resize(frameState->eglWindow, width, height, 0, 0);
 			zwlr_layer_surface_v1_ack_configure(layerSurface, serial);
+			{
+				std::scoped_lock<std::mutex> _ {frameState->mutex};
+				frameState->width = width;
+				frameState->height = height;
+			}
+			frameState->damage.add(photon::Rect{.x = 0, .y = 0, .width = width, .height = height});
+			setDirty(*frameState);
 		},
 		.closed = [](void*, [[maybe_unused]] zwlr_layer_surface_v1* layerSurface) noexcept -> void {}
 	};
 
+	static const wl_callback_listener frameCallbackListener {
+		.done = [](void* data, wl_callback* callback, uint32_t) noexcept -> void {
+			auto frameState {static_cast<Window::FrameState*> (data)};
+			assert(frameState->frameCallback == callback);
+			wl_callback_destroy(frameState->frameCallback.release());
+			if (frameState->dirty && frameState->onFrameReady)
+				frameState->onFrameReady();
+		}
+	};
+
 	Window::~Window() noexcept {
+		if (m_frameState != nullptr && m_frameState->frameCallback != nullptr)
+			wl_callback_destroy(m_frameState->frameCallback.release());
 		if (m_eglSurface != nullptr)
 			eglDestroySurface(m_instance->getEGLDisplay(), m_eglSurface.release());
 		if (m_eglWindow != nullptr)
@@ -120,6 +154,8 @@ namespace photon::wayland {
 		)};
 		if (window.m_eglWindow == nullptr)
 			return std::unexpected(CreateError::eEGLWindowCreation);
+		window.m_frameState = std::make_unique<FrameState> ();
+		window.m_frameState->eglWindow = window.m_eglWindow.get();
 
 		const auto eglSurfaceAttribs {photon::utils::makeArray<const EGLint> (
 			EGL_GL_COLORSPACE, EGL_GL_COLORSPACE_LINEAR,
@@ -142,11 +178,37 @@ namespace photon::wayland {
 			window.m_instance->getEGLContext()
 		) == EGL_FALSE)
 			return std::unexpected(CreateError::eEGLMakeCurrent);
+		// pacing comes from the frame callbacks, a blocking swap would only stall the thread
+		if (eglSwapInterval(window.m_instance->getEGLDisplay(), 0) == EGL_FALSE)
+			return std::unexpected(CreateError::eEGLSwapInterval);
+
+		const std::string_view extensions {eglQueryString(window.m_instance->getEGLDisplay(), EGL_EXTENSIONS)};
+		const auto hasExtension {[&extensions] (std::string_view name) noexcept -> bool {
+			for (std::size_t start {0uz}; start < extensions.size();) {
+				const std::size_t end {std::min(extensions.find(' ', start), extensions.size())};
+				if (extensions.substr(start, end - start) == name)
+					return true;
+				start = end + 1uz;
+			}
+			return false;
+		}};
+		window.m_hasBufferAge = hasExtension("EGL_EXT_buffer_age");
+		window.m_swapBuffersWithDamage = nullptr;
+		if (hasExtension("EGL_KHR_swap_buffers_with_damage")) {
+			window.m_swapBuffersWithDamage = reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC> (
+				eglGetProcAddress("eglSwapBuffersWithDamageKHR")
+			);
+		}
+		else if (hasExtension("EGL_EXT_swap_buffers_with_damage")) {
+			window.m_swapBuffersWithDamage = reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC> (
+				eglGetProcAddress("eglSwapBuffersWithDamageEXT")
+			);
+		}
 
 		if (zwlr_layer_surface_v1_add_listener(
 			window.m_layerSurface.get(),
 			&layerSurfaceListener,
-			window.m_eglWindow.get()
+			window.m_frameState.get()
 		) != 0)
 			return std::unexpected(CreateError::eLayerSurfaceAddListener);
 
@@ -185,19 +247,137 @@ namespace photon::wayland {
 		glDebugMessageCallback(&debugMessengerCallback, nullptr);
 	#endif
 
-		glViewport(0, 0, width, height);
+		// the configure of the roundtrip gave the actual size, one side of the request may be 0
+		glViewport(0, 0, static_cast<GLsizei> (window.m_frameState->width), static_cast<GLsizei> (window.m_frameState->height));
 
 		window.fill({.r = 0, .g = 0, .b = 0, .a = 255});
 		return window;
 	}
 
+	auto Window::markDirty() noexcept -> void {
+		// the size is only written from the rendering thread, no need to lock
+		m_frameState->damage.add(photon::Rect{
+			.x = 0,
+			.y = 0,
+			.width = m_frameState->width,
+			.height = m_frameState->height
+		});
+		setDirty(*m_frameState);
+	}
+
+	auto Window::invalidate(const photon::Rect& rect) noexcept -> void {
+		{
+			std::scoped_lock<std::mutex> _ {m_frameState->mutex};
+			m_frameState->pendingDamage.add(rect);
+		}
+		// only the first invalidation of a frame reaches the eventfd
+		m_frameState->invalidated.notify();
+	}
+
+	auto Window::invalidate() noexcept -> void {
+		{
+			std::scoped_lock<std::mutex> _ {m_frameState->mutex};
+			m_frameState->pendingDamage.add(photon::Rect{
+				.x = 0,
+				.y = 0,
+				.width = m_frameState->width,
+				.height = m_frameState->height
+			});
+		}
+		m_frameState->invalidated.notify();
+	}
+
+	auto Window::processInvalidations() noexcept -> void {
+		m_frameState->invalidated.clear();
+		photon::Region pendingDamage {};
+		{
+			std::scoped_lock<std::mutex> _ {m_frameState->mutex};
+			pendingDamage = std::exchange(m_frameState->pendingDamage, photon::Region{});
+		}
+		if (pendingDamage.empty())
+			return;
+		m_frameState->damage.add(pendingDamage);
+		setDirty(*m_frameState);
+	}
+
+	auto Window::beginFrame() noexcept -> photon::Region {
+		const photon::Rect surface {.x = 0, .y = 0, .width = m_frameState->width, .height = m_frameState->height};
+		photon::Region repaint {m_frameState->damage};
+		EGLint age {0};
+		if (!m_hasBufferAge || eglQuerySurface(
+			m_instance->getEGLDisplay(),
+			m_eglSurface.get(),
+			EGL_BUFFER_AGE_EXT,
+			&age
+		) == EGL_FALSE)
+			age = 0;
+		// an age of 0 means undefined content, 1 that the buffer holds the last presented frame
+		if (age <= 0 || static_cast<std::size_t> (age) > MAX_BUFFER_AGE)
+			repaint = photon::Region{surface};
+		else {
+			const auto& history {m_frameState->damageHistory};
+			for (std::size_t i {0uz}; i + 1uz < static_cast<std::size_t> (age); ++i)
+				repaint.add(history[(m_frameState->historyHead + history.size() - i) % history.size()]);
+		}
+
+		// a single scissor rect, the bounds are close enough for the few rects of a bar
+		const photon::Rect bounds {repaint.getBounds()};
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(
+			bounds.x,
+			static_cast<GLint> (m_frameState->height) - bounds.y - static_cast<GLint> (bounds.height),
+			static_cast<GLsizei> (bounds.width),
+			static_cast<GLsizei> (bounds.height)
+		);
+		return repaint;
+	}
+
+	auto Window::skipFrame() noexcept -> void {
+		m_frameState->dirty = false;
+		m_frameState->damage.clear();
+	}
+
 	auto Window::fill(photon::Color color) noexcept -> void {
 		glClearColor(color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f);
 		glClear(GL_COLOR_BUFFER_BIT);
 	}
 
 	auto Window::present() noexcept -> std::expected<void, PresentError> {
-		if (eglSwapBuffers(m_instance->getEGLDisplay(), m_eglSurface.get()) == EGL_FALSE)
+		// requested before the swap, which commits the surface
+		if (m_frameState->frameCallback == nullptr) {
+			m_frameState->frameCallback = photon::utils::Owned{wl_surface_frame(m_surface.get())};
+			if (m_frameState->frameCallback == nullptr)
+				return std::unexpected(PresentError::eFrameRequest);
+			wl_callback_add_listener(m_frameState->frameCallback.get(), &frameCallbackListener, m_frameState.get());
+		}
+		m_frameState->dirty = false;
+		auto& history {m_frameState->damageHistory};
+		m_frameState->historyHead = (m_frameState->historyHead + 1uz) % history.size();
+		history[m_frameState->historyHead] = std::exchange(m_frameState->damage, photon::Region{});
+		const photon::Region& damage {history[m_frameState->historyHead]};
+		glDisable(GL_SCISSOR_TEST);
+
+		if (m_swapBuffersWithDamage == nullptr || damage.empty()) {
+			if (eglSwapBuffers(m_instance->getEGLDisplay(), m_eglSurface.get()) == EGL_FALSE)
+				return std::unexpected(PresentError::eBufferSwapping);
+			return {};
+		}
+		// EGL damage rects have their origin at the bottom left
+		std::array<EGLint, photon::Region::MAX_RECTS * 4uz> rects {};
+		std::size_t rectCount {0uz};
+		for (const auto& rect : damage.getRects()) {
+			rects[rectCount * 4uz + 0uz] = rect.x;
+			rects[rectCount * 4uz + 1uz] = static_cast<EGLint> (m_frameState->height) - rect.y - static_cast<EGLint> (rect.height);
+			rects[rectCount * 4uz + 2uz] = static_cast<EGLint> (rect.width);
+			rects[rectCount * 4uz + 3uz] = static_cast<EGLint> (rect.height);
+			++rectCount;
+		}
+		if (m_swapBuffersWithDamage(
+			m_instance->getEGLDisplay(),
+			m_eglSurface.get(),
+			rects.data(),
+			static_cast<EGLint> (rectCount)
+		) == EGL_FALSE)
 			return std::unexpected(PresentError::eBufferSwapping);
 		return {};
 	}
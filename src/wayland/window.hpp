@@ -1,9 +1,14 @@
 #pragma once
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string_view>
 
 #include <wayland-client-protocol.h>
@@ -11,6 +16,8 @@
 #include <wlr-layer-shell-unstable-v1/wlr-layer-shell-unstable-v1-protocol.h>
 
 #include "color.hpp"
+#include "events/eventFdSignal.hpp"
+#include "rect.hpp"
 #include "utils/semantic.hpp"
 #include "wayland/instance.hpp"
 
@@ -26,9 +33,11 @@ namespace photon::wayland {
 				eLayerSurfaceAddListener,
 				eEGLSurfaceCreation,
 				eEGLMakeCurrent,
+				eEGLSwapInterval,
 				eOpenGLFunctionsLoading,
 			};
 			enum class PresentError {
+				eFrameRequest,
 				eBufferSwapping,
 			};
 			enum class Anchor {
@@ -43,6 +52,29 @@ namespace photon::wayland {
 				uint32_t size;
 				Anchor anchor;
 			};
+			using FrameReadyCallback = std::move_only_function<void() noexcept>;
+			// back buffers older than this are redrawn entirely
+			static constexpr std::size_t MAX_BUFFER_AGE {4uz};
+			struct FrameState {
+				wl_egl_window* eglWindow {nullptr};
+				// pending `wl_surface_frame` of the last presented frame
+				photon::utils::Owned<wl_callback*> frameCallback {};
+				bool dirty {true};
+				FrameReadyCallback onFrameReady {};
+				// damage of the next frame, only touched by the rendering thread
+				photon::Region damage {};
+				// damage of the last presented frames, most recent at `historyHead`, to rebuild the
+				// content of back buffers older than the front one
+				std::array<photon::Region, MAX_BUFFER_AGE - 1uz> damageHistory {};
+				std::size_t historyHead {0uz};
+				// filled by `invalidate` from any thread, guarded by `mutex`
+				std::mutex mutex {};
+				photon::Region pendingDamage {};
+				std::uint32_t width {0u};
+				std::uint32_t height {0u};
+				// readable once `pendingDamage` holds something
+				photon::events::EventFdSignal invalidated {};
+			};
 
 			Window(const Window&) = delete;
 			auto operator=(const Window&) -> Window& = delete;
@@ -53,7 +85,47 @@ namespace photon::wayland {
 
 			static auto create(const CreateInfos& createInfos) noexcept -> std::expected<Window, CreateError>;
 
+			// called once the content is dirty and the compositor is ready for a new frame, which is
+			// the only time rendering is worth it. May be called from `markDirty` or from the
+			// dispatch of the wayland events
+			inline auto setFrameReadyCallback(FrameReadyCallback&& callback) noexcept -> void {
+				m_frameState->onFrameReady = std::move(callback);
+			}
+			// damage the whole window, from the rendering thread
+			auto markDirty() noexcept -> void;
+			// may be called from any thread, as often as needed : every invalidation arriving within a
+			// frame is merged and handled by a single `processInvalidations`
+			auto invalidate(const photon::Rect& rect) noexcept -> void;
+			auto invalidate() noexcept -> void;
+			// readable when invalidations are pending, to be watched by the rendering thread which
+			// then calls `processInvalidations`
+			inline auto getInvalidationFd() const noexcept -> int {
+				return m_frameState->invalidated.getFd();
+			}
+			auto processInvalidations() noexcept -> void;
+			inline auto getWidth() const noexcept -> std::uint32_t {
+				return m_frameState->width;
+			}
+			inline auto getHeight() const noexcept -> std::uint32_t {
+				return m_frameState->height;
+			}
+			// what changed since the last `present`
+			inline auto getDamage() const noexcept -> const photon::Region& {
+				return m_frameState->damage;
+			}
+			inline auto isFrameReady() const noexcept -> bool {
+				return m_frameState->dirty && m_frameState->frameCallback == nullptr;
+			}
+
+			// must be called before drawing a frame. Returns the region of the back buffer that is
+			// out of date, which is the damage of this frame plus the one of the frames the buffer
+			// missed according to its age. Drawing is scissored to its bounds
+			auto beginFrame() noexcept -> photon::Region;
+			// drop the pending frame without presenting it, when its content turned out unchanged
+			auto skipFrame() noexcept -> void;
 			auto fill(photon::Color color) noexcept -> void;
+			// throttled by the frame callback of the compositor, the swap itself never blocks. Only
+			// the damage of the frame is sent to the compositor
 			auto present() noexcept -> std::expected<void, PresentError>;
 
 		private:
@@ -64,5 +136,10 @@ namespace photon::wayland {
 			photon::utils::Owned<zwlr_layer_surface_v1*> m_layerSurface;
 			photon::utils::Owned<wl_egl_window*> m_eglWindow;
 			photon::utils::Owned<EGLSurface> m_eglSurface;
+			// must be on the heap to keep consistent address for C-callback
+			std::unique_ptr<FrameState> m_frameState;
+			bool m_hasBufferAge;
+			// null when neither `EGL_KHR_swap_buffers_with_damage` nor its EXT version are supported
+			PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC m_swapBuffersWithDamage;
 	};
 }
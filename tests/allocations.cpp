@@ -0,0 +1,170 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <print>
+
+#include "event.hpp"
+
+
+// every allocation of the process goes through these, so that the test can check that the
+// steady state of the queues never reaches the allocator
+static std::atomic<std::size_t> allocationCount {0uz};
+
+static auto countedAllocate(std::size_t size) noexcept -> void* {
+	allocationCount.fetch_add(1uz, std::memory_order_relaxed);
+	return std::malloc(size == 0uz ? 1uz : size);
+}
+static auto countedAllocate(std::size_t size, std::align_val_t alignment) noexcept -> void* {
+	allocationCount.fetch_add(1uz, std::memory_order_relaxed);
+	const auto align {static_cast<std::size_t> (alignment)};
+	return std::aligned_alloc(align, (size + align - 1uz) / align * align);
+}
+
+auto operator new(std::size_t size) -> void* {
+	if (void* pointer {countedAllocate(size)})
+		return pointer;
+	throw std::bad_alloc{};
+}
+auto operator new[](std::size_t size) -> void* {
+	return ::operator new(size);
+}
+auto operator new(std::size_t size, std::align_val_t alignment) -> void* {
+	if (void* pointer {countedAllocate(size, alignment)})
+		return pointer;
+	throw std::bad_alloc{};
+}
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void* {
+	return ::operator new(size, alignment);
+}
+auto operator new(std::size_t size, const std::nothrow_t&) noexcept -> void* {
+	return countedAllocate(size);
+}
+auto operator new[](std::size_t size, const std::nothrow_t&) noexcept -> void* {
+	return countedAllocate(size);
+}
+auto operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept -> void* {
+	return countedAllocate(size, alignment);
+}
+auto operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept -> void* {
+	return countedAllocate(size, alignment);
+}
+
+auto operator delete(void* pointer) noexcept -> void {std::free(pointer);}
+auto operator delete[](void* pointer) noexcept -> void {std::free(pointer);}
+auto operator delete(void* pointer, std::size_t) noexcept -> void {std::free(pointer);}
+auto operator delete[](void* pointer, std::size_t) noexcept -> void {std::free(pointer);}
+auto operator delete(void* pointer, std::align_val_t) noexcept -> void {std::free(pointer);}
+auto operator delete[](void* pointer, std::align_val_t) noexcept -> void {std::free(pointer);}
+auto operator delete(void* pointer, std::size_t, std::align_val_t) noexcept -> void {std::free(pointer);}
+auto operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept -> void {std::free(pointer);}
+auto operator delete(void* pointer, const std::nothrow_t&) noexcept -> void {std::free(pointer);}
+auto operator delete[](void* pointer, const std::nothrow_t&) noexcept -> void {std::free(pointer);}
+auto operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept -> void {std::free(pointer);}
+auto operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept -> void {std::free(pointer);}
+
+
+static constexpr std::size_t BATCH_SIZE {64uz};
+static constexpr std::size_t BATCH_COUNT {100'000uz};
+
+enum class TestEventType {
+	eSmall,
+	eMedium,
+	eLarge,
+};
+
+struct Medium {
+	std::array<std::uint64_t, 4uz> words;
+};
+static_assert(sizeof(photon::Event<TestEventType::eMedium, Medium>) <= photon::EventQueueConfig{}.inlineEventSize);
+
+// bigger than `inlineEventSize`, so stored out-of-line
+struct Large {
+	std::array<std::uint64_t, 32uz> words;
+};
+static_assert(sizeof(photon::Event<TestEventType::eLarge, Large>) > photon::EventQueueConfig{}.inlineEventSize);
+
+struct Visitor {
+	std::size_t handled {0uz};
+
+	auto handle(photon::Event<TestEventType::eSmall, std::uint32_t>) noexcept -> void {++handled;}
+	auto handle(photon::Event<TestEventType::eMedium, Medium>) noexcept -> void {++handled;}
+	auto handle(photon::Event<TestEventType::eLarge, Large>) noexcept -> void {++handled;}
+};
+
+template <photon::EventQueueConfig config>
+using TestQueue = photon::BasicEventQueue<config, TestEventType,
+	photon::Event<TestEventType::eSmall, std::uint32_t>,
+	photon::Event<TestEventType::eMedium, Medium>,
+	photon::Event<TestEventType::eLarge, Large>
+>;
+
+template <photon::EventQueueConfig config>
+static auto pushBatch(TestQueue<config>& queue, std::size_t batch) noexcept -> bool {
+	for (std::size_t i {0uz}; i < BATCH_SIZE; i += 2uz) {
+		if (!queue.template push<TestEventType::eSmall> (static_cast<std::uint32_t> (batch + i)))
+			return false;
+		if (!queue.template push<TestEventType::eMedium> (Medium{.words = {batch, i}}))
+			return false;
+	}
+	return true;
+}
+
+// push and drain inline-sized events once to reach the peak depth, then count the allocations
+// of as many batches again
+template <photon::EventQueueConfig config>
+static auto testSteadyState(const char* name) noexcept -> bool {
+	TestQueue<config> queue {name};
+	Visitor visitor {};
+	if (!pushBatch(queue, 0uz) || queue.drain(visitor) != BATCH_SIZE) {
+		std::println(stderr, "{} : warm-up failed", name);
+		return false;
+	}
+
+	allocationCount.store(0uz, std::memory_order_relaxed);
+	std::size_t drained {0uz};
+	for (std::size_t batch {0uz}; batch < BATCH_COUNT; ++batch) {
+		if (!pushBatch(queue, batch)) {
+			std::println(stderr, "{} : push failed", name);
+			return false;
+		}
+		drained += queue.drain(visitor);
+	}
+	const std::size_t allocations {allocationCount.load(std::memory_order_relaxed)};
+
+	if (drained != BATCH_SIZE * BATCH_COUNT) {
+		std::println(stderr, "{} : {} events drained instead of {}", name, drained, BATCH_SIZE * BATCH_COUNT);
+		return false;
+	}
+	if (allocations != 0uz) {
+		std::println(stderr, "{} : {} allocations for {} events", name, allocations, drained);
+		return false;
+	}
+
+	// makes sure that the counter does see the queue allocating
+	allocationCount.store(0uz, std::memory_order_relaxed);
+	if (!queue.template push<TestEventType::eLarge> (Large{}) || queue.drain(visitor) != 1uz) {
+		std::println(stderr, "{} : out-of-line event lost", name);
+		return false;
+	}
+	if (allocationCount.load(std::memory_order_relaxed) == 0uz) {
+		std::println(stderr, "{} : out-of-line event did not allocate", name);
+		return false;
+	}
+	return true;
+}
+
+auto main() -> int {
+	bool succeeded {true};
+	succeeded &= testSteadyState<photon::EventQueueConfig{
+		.backend = photon::EventQueueBackend::eMutex,
+		.capacity = BATCH_SIZE
+	}> ("mutex allocation test");
+	succeeded &= testSteadyState<photon::EventQueueConfig{
+		.backend = photon::EventQueueBackend::eLockFreeRing,
+		.capacity = BATCH_SIZE
+	}> ("lock-free allocation test");
+	return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,159 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <thread>
+#include <vector>
+
+#include "broadcast.hpp"
+
+
+static constexpr std::size_t SUBSCRIBER_COUNT {4uz};
+static constexpr std::uint64_t EVENT_COUNT {100'000u};
+static constexpr std::size_t RING_CAPACITY {8uz};
+
+enum class TestEventType {
+	eSequence,
+};
+
+using SequenceEvent = photon::Event<TestEventType::eSequence, std::uint64_t>;
+using TestQueue = photon::BasicBroadcastQueue<photon::BroadcastQueueConfig{
+	.capacity = RING_CAPACITY,
+	.maxSubscribers = SUBSCRIBER_COUNT
+}, TestEventType, SequenceEvent>;
+
+// checks that the events are seen in order from `first`, without gaps nor duplicates
+struct OrderChecker {
+	std::uint64_t expected {0u};
+	bool failed {false};
+
+	auto handle(const SequenceEvent& event) noexcept -> void {
+		if (event.value != expected) {
+			std::println(stderr, "expected {}, got {}", expected, event.value);
+			failed = true;
+		}
+		expected = event.value + 1u;
+	}
+};
+
+// every subscriber sees every event, through a ring much smaller than the total
+static auto testFanOut() noexcept -> bool {
+	TestQueue queue {"broadcast test"};
+	std::vector<TestQueue::Subscription> subscriptions {};
+	for (std::size_t i {0uz}; i < SUBSCRIBER_COUNT; ++i) {
+		auto subscription {queue.subscribe()};
+		if (!subscription) {
+			std::println(stderr, "fan-out : subscription {} failed", i);
+			return false;
+		}
+		subscriptions.push_back(std::move(*subscription));
+	}
+	if (queue.subscribe()) {
+		std::println(stderr, "fan-out : subscribed past maxSubscribers");
+		return false;
+	}
+
+	std::vector<OrderChecker> checkers (SUBSCRIBER_COUNT);
+	{
+		std::vector<std::jthread> subscribers {};
+		for (std::size_t i {0uz}; i < SUBSCRIBER_COUNT; ++i) {
+			subscribers.emplace_back([&subscription = subscriptions[i], &checker = checkers[i]] noexcept {
+				while (checker.expected < EVENT_COUNT)
+					subscription.waitOnEvents(checker);
+			});
+		}
+		for (std::uint64_t i {0u}; i < EVENT_COUNT; ++i)
+			queue.push<TestEventType::eSequence> (i);
+	}
+	for (const OrderChecker& checker : checkers) {
+		if (checker.failed || checker.expected != EVENT_COUNT) {
+			std::println(stderr, "fan-out : {} events received", checker.expected);
+			return false;
+		}
+	}
+	return true;
+}
+
+// a subscriber that stops polling holds the producers back instead of having its events
+// overwritten, and gets all of them once it resumes
+static auto testSlowSubscriber() noexcept -> bool {
+	TestQueue queue {"broadcast test"};
+	auto fast {queue.subscribe()};
+	auto slow {queue.subscribe()};
+	if (!fast || !slow) {
+		std::println(stderr, "slow subscriber : subscription failed");
+		return false;
+	}
+
+	std::atomic<std::uint64_t> pushed {0u};
+	OrderChecker fastChecker {};
+	OrderChecker slowChecker {};
+	{
+		std::jthread producer {[&queue, &pushed] noexcept {
+			for (std::uint64_t i {0u}; i < EVENT_COUNT; ++i) {
+				queue.push<TestEventType::eSequence> (i);
+				pushed.fetch_add(1u, std::memory_order::relaxed);
+			}
+		}};
+		std::jthread fastSubscriber {[&fast, &fastChecker] noexcept {
+			while (fastChecker.expected < EVENT_COUNT)
+				fast->waitOnEvents(fastChecker);
+		}};
+
+		std::this_thread::sleep_for(std::chrono::milliseconds{50});
+		if (pushed.load(std::memory_order::relaxed) > RING_CAPACITY) {
+			std::println(stderr, "slow subscriber : overrun, {} events pushed", pushed.load(std::memory_order::relaxed));
+			slowChecker.failed = true;
+		}
+		while (slowChecker.expected < EVENT_COUNT)
+			slow->waitOnEvents(slowChecker);
+	}
+	if (fastChecker.failed || slowChecker.failed)
+		return false;
+	return fastChecker.expected == EVENT_COUNT && slowChecker.expected == EVENT_COUNT;
+}
+
+// a subscription only sees the events pushed after it was made
+static auto testLateSubscription() noexcept -> bool {
+	TestQueue queue {"broadcast test"};
+	// nobody is subscribed, so the ring wraps around freely
+	static constexpr std::uint64_t EARLY_COUNT {RING_CAPACITY * 3u};
+	for (std::uint64_t i {0u}; i < EARLY_COUNT; ++i)
+		queue.push<TestEventType::eSequence> (i);
+
+	auto subscription {queue.subscribe()};
+	if (!subscription) {
+		std::println(stderr, "late subscription : subscription failed");
+		return false;
+	}
+	OrderChecker checker {.expected = EARLY_COUNT};
+	if (subscription->poll(checker) != 0uz) {
+		std::println(stderr, "late subscription : events pushed before subscribing were received");
+		return false;
+	}
+	for (std::uint64_t i {EARLY_COUNT}; i < EARLY_COUNT + RING_CAPACITY; ++i)
+		queue.push<TestEventType::eSequence> (i);
+	if (subscription->poll(checker) != RING_CAPACITY || checker.failed) {
+		std::println(stderr, "late subscription : {} events received", checker.expected - EARLY_COUNT);
+		return false;
+	}
+	return true;
+}
+
+auto main() -> int {
+	if (!testFanOut()) {
+		std::println(stderr, "broadcast fan-out test failed");
+		return EXIT_FAILURE;
+	}
+	if (!testSlowSubscriber()) {
+		std::println(stderr, "broadcast slow subscriber test failed");
+		return EXIT_FAILURE;
+	}
+	if (!testLateSubscription()) {
+		std::println(stderr, "broadcast late subscription test failed");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <thread>
+#include <vector>
+
+#include "event.hpp"
+#include "events/mpscRing.hpp"
+
+
+// producers push their own increasing sequence numbers through a ring much smaller than the total,
+// so it wraps around thousands of times. The consumer checks that every producer is seen in order,
+// without gaps nor duplicates
+static constexpr std::uint32_t PRODUCER_COUNT {4u};
+static constexpr std::uint64_t EVENTS_PER_PRODUCER {1'000'000u};
+static constexpr std::size_t RING_CAPACITY {256uz};
+
+struct Tagged {
+	std::uint32_t producer;
+	std::uint64_t sequence;
+};
+
+class OrderChecker final {
+	public:
+		OrderChecker() noexcept : m_expected(PRODUCER_COUNT, 0u) {}
+
+		auto check(const Tagged& tagged) noexcept -> void {
+			if (tagged.producer >= PRODUCER_COUNT) {
+				std::println(stderr, "unknown producer {}", tagged.producer);
+				m_failed = true;
+				return;
+			}
+			std::uint64_t& expected {m_expected[tagged.producer]};
+			if (tagged.sequence != expected) {
+				std::println(stderr, "producer {} : expected {}, got {}", tagged.producer, expected, tagged.sequence);
+				m_failed = true;
+			}
+			expected = tagged.sequence + 1u;
+			++m_received;
+		}
+
+		auto getReceived() const noexcept -> std::uint64_t {
+			return m_received;
+		}
+		auto succeeded() const noexcept -> bool {
+			if (m_failed)
+				return false;
+			for (std::uint32_t producer {0u}; producer < PRODUCER_COUNT; ++producer) {
+				if (m_expected[producer] != EVENTS_PER_PRODUCER) {
+					std::println(stderr, "producer {} : {} events received", producer, m_expected[producer]);
+					return false;
+				}
+			}
+			return true;
+		}
+
+	private:
+		std::vector<std::uint64_t> m_expected;
+		std::uint64_t m_received {0u};
+		bool m_failed {false};
+};
+
+static auto testRing() noexcept -> bool {
+	photon::events::MpscRing<Tagged> ring {RING_CAPACITY};
+	std::vector<std::jthread> producers {};
+	for (std::uint32_t producer {0u}; producer < PRODUCER_COUNT; ++producer) {
+		producers.emplace_back([&ring, producer] noexcept {
+			for (std::uint64_t sequence {0u}; sequence < EVENTS_PER_PRODUCER; ++sequence) {
+				while (!ring.tryPush(Tagged{.producer = producer, .sequence = sequence}))
+					std::this_thread::yield();
+			}
+		});
+	}
+
+	OrderChecker checker {};
+	while (checker.getReceived() < PRODUCER_COUNT * EVENTS_PER_PRODUCER) {
+		if (ring.drain([&checker] (Tagged&& tagged) noexcept {checker.check(tagged);}, RING_CAPACITY) == 0uz)
+			std::this_thread::yield();
+	}
+	producers.clear();
+	// nothing may be left once every producer is done
+	if (ring.tryPop()) {
+		std::println(stderr, "ring : duplicated event");
+		return false;
+	}
+	return checker.succeeded();
+}
+
+
+enum class TestEventType {
+	eTagged,
+};
+
+struct QueueVisitor {
+	OrderChecker checker;
+
+	auto handle(photon::Event<TestEventType::eTagged, Tagged> event) noexcept -> void {
+		checker.check(event.value);
+	}
+};
+
+// same through the public api of the queue, with producers blocking on the full ring
+static auto testQueue() noexcept -> bool {
+	photon::BasicEventQueue<photon::EventQueueConfig{
+		.backend = photon::EventQueueBackend::eLockFreeRing,
+		.capacity = RING_CAPACITY
+	}, TestEventType, photon::Event<TestEventType::eTagged, Tagged>> queue {"mpscRing test"};
+	std::vector<std::jthread> producers {};
+	for (std::uint32_t producer {0u}; producer < PRODUCER_COUNT; ++producer) {
+		producers.emplace_back([&queue, producer] noexcept {
+			for (std::uint64_t sequence {0u}; sequence < EVENTS_PER_PRODUCER; ++sequence) {
+				if (!queue.push<TestEventType::eTagged> (Tagged{.producer = producer, .sequence = sequence}))
+					std::println(stderr, "queue : push failed");
+			}
+		});
+	}
+
+	QueueVisitor visitor {};
+	while (visitor.checker.getReceived() < PRODUCER_COUNT * EVENTS_PER_PRODUCER)
+		queue.waitOnEvents(visitor);
+	producers.clear();
+	if (queue.drain(visitor) != 0uz) {
+		std::println(stderr, "queue : duplicated event");
+		return false;
+	}
+	return visitor.checker.succeeded();
+}
+
+auto main() -> int {
+	if (!testRing()) {
+		std::println(stderr, "MpscRing stress test failed");
+		return EXIT_FAILURE;
+	}
+	if (!testQueue()) {
+		std::println(stderr, "lock-free EventQueue stress test failed");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}